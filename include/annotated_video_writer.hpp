@@ -0,0 +1,95 @@
+#pragma once
+
+#include "config_manager.hpp"
+#include "frame_source.hpp"
+#include "logger.hpp"
+#include "raw_frame_container.hpp"
+#include "yolov8_postprocessor.hpp"
+#include "yolov8_visualizer.hpp"
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// What submit() does when the encoder falls behind and the queue is full
+enum class BackpressurePolicy {
+    Drop,           // Discard the new frame
+    Block,          // Wait for the encoder (offline audits only: adds detection latency)
+    Downsample      // Keep every other frame once the queue is half full, drop when full
+};
+
+struct OutputOptions {
+    bool enabled = false;
+    std::string path = "output/annotated.mp4";   // .raw writes a raw frame container
+    std::string fourcc = "mp4v";
+    double fps = 60.0;
+    size_t queue_size = 8;
+    BackpressurePolicy policy = BackpressurePolicy::Drop;
+    bool render = true;                          // Draw the detections on the writer thread
+};
+
+struct OutputStats {
+    uint64_t submitted = 0;
+    uint64_t written = 0;
+    uint64_t dropped = 0;
+    uint64_t downsampled = 0;
+    size_t max_queue_depth = 0;
+};
+
+// Output sink for annotated video. Frames are copied into pooled buffers and
+// handed to a dedicated encoder thread through a bounded queue, so encoding
+// never runs on the detection loop.
+class AnnotatedVideoWriter {
+private:
+    struct QueuedFrame {
+        cv::Mat image;
+        PixelFormat format = PixelFormat::BGR;
+        std::vector<Detection> detections;
+        int64_t timestamp_us = 0;
+    };
+
+    OutputOptions options;
+    YOLOv8Visualizer visualizer;
+    cv::VideoWriter video_writer;
+    RawFrameRecorder raw_recorder;
+    bool raw_output = false;
+    bool output_failed = false;
+    cv::Mat bgr_scratch;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_not_empty;
+    std::condition_variable queue_not_full;
+    std::deque<std::unique_ptr<QueuedFrame>> queue;
+    std::vector<std::unique_ptr<QueuedFrame>> free_frames;   // Recycled buffers
+    bool stopping = false;
+    bool downsample_toggle = false;
+    OutputStats stats;
+    std::thread writer_thread;
+    Logger logger;
+
+public:
+    explicit AnnotatedVideoWriter(const OutputOptions& output_options, const std::string& config_file = "blood.cfg");
+    ~AnnotatedVideoWriter();
+
+    AnnotatedVideoWriter(const AnnotatedVideoWriter&) = delete;
+    AnnotatedVideoWriter& operator=(const AnnotatedVideoWriter&) = delete;
+
+    // False when the frame was dropped by the backpressure policy
+    bool submit(const cv::Mat& image, Span<const Detection> detections, int64_t timestamp_us = 0);
+    // Flushes the queue and finalizes the output file
+    void close();
+
+    OutputStats get_stats();
+
+    static OutputOptions options_from_config(ConfigManager& config);
+    static BackpressurePolicy parse_policy(const std::string& value);
+
+private:
+    void writer_loop();
+    void write_frame(QueuedFrame& frame);
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "config_manager.hpp"
+#include "detection_workspace.hpp"
+#include "logger.hpp"
+#include "model_slot.hpp"
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct DetectionResult {
+    uint64_t sequence = 0;             // Submission order
+    std::vector<Detection> detections;
+    DetectionTimings timings;
+    double latency_ms = 0.0;           // Submit to completion, including queueing
+    std::string error;                 // Set when detection failed (callback variant)
+};
+
+struct AsyncDetectorOptions {
+    int num_workers = 2;
+    size_t max_in_flight = 4;          // Submissions block while this many are pending
+    bool ordered_callbacks = true;     // Deliver callbacks in submission order
+    bool copy_frames = true;           // false: caller guarantees the frame buffer is not reused
+};
+
+// Submission queue and worker threads around a shared model. Each worker owns
+// a DetectionWorkspace; the model runs concurrently across workers. Each request
+// runs on the model current when it is dequeued.
+class AsyncDetector {
+public:
+    using Callback = std::function<void(DetectionResult&)>;
+
+private:
+    struct Request {
+        uint64_t sequence = 0;
+        uint64_t delivery_sequence = 0;    // Position among ordered callbacks
+        cv::Mat frame;
+        std::chrono::steady_clock::time_point submitted;
+        bool has_promise = false;
+        std::promise<DetectionResult> promise;
+        Callback callback;
+    };
+
+    std::shared_ptr<ModelSlot> models;
+    AsyncDetectorOptions options;
+    std::vector<std::unique_ptr<DetectionWorkspace>> workspaces;
+    std::vector<std::thread> workers;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_not_empty;
+    std::condition_variable slot_available;
+    std::deque<std::unique_ptr<Request>> queue;
+    size_t in_flight = 0;
+    uint64_t next_sequence = 0;
+    bool stopping = false;
+
+    uint64_t next_callback_sequence = 0;
+
+    // Reorder buffer for ordered callbacks; one worker at a time delivers, outside the lock
+    std::mutex delivery_mutex;
+    std::map<uint64_t, std::pair<Callback, DetectionResult>> completed;
+    uint64_t next_delivery = 0;
+    bool delivering = false;
+    Logger logger;
+
+public:
+    AsyncDetector(std::shared_ptr<ModelSlot> shared_models, ConfigManager& config,
+                  const AsyncDetectorOptions& detector_options);
+    ~AsyncDetector();
+
+    AsyncDetector(const AsyncDetector&) = delete;
+    AsyncDetector& operator=(const AsyncDetector&) = delete;
+
+    std::future<DetectionResult> submit(const cv::Mat& frame);
+    void submit(const cv::Mat& frame, Callback callback);
+
+    size_t get_in_flight();
+    const AsyncDetectorOptions& get_options() const { return options; }
+
+    static AsyncDetectorOptions options_from_config(ConfigManager& config);
+
+private:
+    void enqueue(std::unique_ptr<Request> request);
+    void worker_loop(int worker_id);
+    void complete(std::unique_ptr<Request> request, DetectionResult& result);
+    void invoke(Callback& callback, DetectionResult& result);
+    void release_slot();
+};
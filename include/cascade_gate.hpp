@@ -0,0 +1,78 @@
+#pragma once
+
+#include "config_manager.hpp"
+#include "logger.hpp"
+#include "yolov8_model.hpp"
+#include "yolov8_preprocessor.hpp"
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+
+struct CascadeOptions {
+    bool enabled = false;
+    std::string gate_model_path = "models/gate.onnx";
+    float gate_threshold = 0.25f;      // Gate score that triggers the full detector
+    int refresh_interval = 30;         // Run the full detector at least every N frames (0 = never)
+    int hold_frames = 10;              // Keep the full detector on for N frames after a detection
+    int gate_threads = 1;
+    bool audit = false;                // Always run the full detector, only measure the gate
+};
+
+struct CascadeDecision {
+    bool run_full = false;
+    bool gate_fired = false;
+    bool held = false;
+    bool refresh = false;
+    bool skipped = false;              // The cascade alone would not run the full detector
+    float gate_score = 0.0f;
+};
+
+struct CascadeStats {
+    uint64_t frames = 0;
+    uint64_t gate_fired = 0;
+    uint64_t held = 0;
+    uint64_t refreshes = 0;
+    uint64_t full_runs = 0;
+    uint64_t skipped = 0;              // Frames answered by the gate alone (in audit: would have been)
+    uint64_t negatives_checked = 0;    // Full detector runs on frames where the gate did not fire
+    uint64_t gate_misses = 0;          // Full detector found objects the gate did not fire on
+    uint64_t skipped_with_detections = 0;  // Audit only: skipped frames that had detections
+    double gate_ms_total = 0.0;
+};
+
+// Cheap first stage of the detector cascade. A small classifier or detector
+// scores a downscaled frame; the full model only runs when the gate fires,
+// shortly after a detection, or on a periodic refresh.
+//
+// Gate outputs understood:
+//   [1, 1] / [1, K]       classifier: object probability / max over classes 1..K-1 (0 = empty)
+//   [1, 4+C, N]           YOLOv8 head: max class score
+//   [num_dets, 6]         in-graph NMS (tools/append_nms.py): max score
+class CascadeGate {
+private:
+    CascadeOptions options;
+    std::unique_ptr<YOLOv8Model> gate_model;
+    YOLOv8Preprocessor preprocessor;
+    CascadeStats stats;
+    int frames_since_full = 0;
+    int hold_remaining = 0;
+    Logger logger;
+
+public:
+    explicit CascadeGate(const CascadeOptions& cascade_options);
+    ~CascadeGate() = default;
+
+    CascadeDecision evaluate(const cv::Mat& image);
+    // Outcome of the full detector for a frame where decision.run_full was set
+    void record(const CascadeDecision& decision, size_t num_detections);
+
+    void warmup(int iterations) { gate_model->warmup(iterations); }
+
+    const CascadeStats& get_stats() const { return stats; }
+    const CascadeOptions& get_options() const { return options; }
+
+    static CascadeOptions options_from_config(ConfigManager& config);
+
+private:
+    float gate_score(const cv::Mat& image);
+};
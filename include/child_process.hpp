@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Minimal local child process: started with an argument vector (no shell),
+// polled for exit without blocking. Used by tools that fan work out to
+// worker processes.
+class ChildProcess {
+private:
+#ifdef _WIN32
+    void* process_handle = nullptr;
+#else
+    int pid = -1;
+#endif
+
+public:
+    ChildProcess() = default;
+    // A still-running child is terminated
+    ~ChildProcess();
+
+    ChildProcess(const ChildProcess&) = delete;
+    ChildProcess& operator=(const ChildProcess&) = delete;
+
+    // args[0] is the program name seen by the child
+    bool start(const std::string& executable, const std::vector<std::string>& args);
+    bool is_running() const;
+    // True once the child has exited; exit_code is -1 when it was killed by a signal
+    bool poll(int& exit_code);
+    void terminate();
+};
+
+// Restricts the calling process (and threads created after the call) to the given
+// logical cores; false when unsupported or refused. Windows: first 64 cores only.
+bool pin_current_process(const std::vector<int>& cores);
+
+// Called in a child: it is terminated when its parent exits, even when the parent is
+// killed (Linux: parent-death signal; Windows: ChildProcess job). False when unsupported.
+bool exit_with_parent();
+
+// Path of the running executable, for re-spawning it as a worker (falls back to argv0)
+std::string current_executable_path(const char* argv0);
@@ -10,6 +10,7 @@
 class ConfigManager {
 private:
     std::map<std::string, std::map<std::string, std::string>> config;
+    std::map<std::string, std::map<std::string, std::string>> overrides;   // set_string values
     std::string config_file;
     
 public:
@@ -64,13 +65,35 @@ public:
         return true;
     }
     
+    // Lookups never insert, so a loaded config can be shared by threads initializing in parallel
     std::string get_string(const std::string& section, const std::string& key, const std::string& default_value = "") {
-        if (config.find(section) != config.end() && config[section].find(key) != config[section].end()) {
-            return config[section][key];
+        auto section_it = config.find(section);
+        if (section_it != config.end()) {
+            auto key_it = section_it->second.find(key);
+            if (key_it != section_it->second.end()) {
+                return key_it->second;
+            }
         }
         return default_value;
     }
     
+    // Command line overrides; not synchronized with concurrent lookups
+    void set_string(const std::string& section, const std::string& key, const std::string& value) {
+        config[section][key] = value;
+        overrides[section][key] = value;
+    }
+    
+    // The file as it is now, with this config's overrides applied on top
+    ConfigManager reloaded() const {
+        auto fresh = ConfigManager(config_file);
+        for (const auto& section : overrides) {
+            for (const auto& entry : section.second) {
+                fresh.set_string(section.first, entry.first, entry.second);
+            }
+        }
+        return fresh;
+    }
+    
     int get_int(const std::string& section, const std::string& key, int default_value = 0) {
         std::string value = get_string(section, key, "");
         if (!value.empty()) {
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "config_manager.hpp"
+#include "cpu_kernels.hpp"
+#include <atomic>
+#include <string>
+
+// Picks the kernel variant once per process: the best one the CPU and OS
+// support (cpuid + xgetbv), optionally capped by [CPU] enable_simd / kernel_isa
+// or the DOGAI_CPU_ISA environment variable (takes precedence, for testing).
+class CpuDispatch {
+public:
+    // Best variant this machine can run
+    static CpuIsa detect();
+    // Applies the config/environment override; call before the first kernels() use
+    static void configure(ConfigManager& config);
+    // Forces a variant, clamped to what the CPU supports; returns the one selected
+    static CpuIsa select(CpuIsa requested);
+    static const CpuKernels& kernels() {
+        auto table = active.load(std::memory_order_acquire);
+        return table ? *table : initialize();
+    }
+
+    static const char* isa_name(CpuIsa isa);
+    // "generic", "sse42", "avx2", "avx512" or "auto"; false for anything else
+    static bool parse_isa(const std::string& value, CpuIsa& isa, bool& automatic);
+    // "avx2 (detected avx512, override)" for benchmark output
+    static std::string describe();
+
+private:
+    static std::atomic<const CpuKernels*> active;
+    static const CpuKernels& initialize();
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+// Kept free of standard library and OpenCV headers: it is included by the
+// per-ISA kernel translation units (src/cpu_kernels_*.cpp), which are compiled
+// with their own target flags.
+#include <cstddef>
+#include <cstdint>
+
+enum class CpuIsa {
+    Generic,    // Baseline of the build target (SSE2 on x86-64)
+    SSE42,
+    AVX2,       // AVX2 + FMA
+    AVX512      // AVX-512 F/BW/VL/DQ
+};
+
+// Boxes in structure-of-arrays form for the overlap kernel (x2 = x + width)
+struct BoxArrays {
+    const float* x1 = nullptr;
+    const float* y1 = nullptr;
+    const float* x2 = nullptr;
+    const float* y2 = nullptr;
+    const float* area = nullptr;
+    const int* class_id = nullptr;     // nullptr: class-agnostic suppression
+};
+
+// Entry points of one kernel variant. Every variant produces bit-identical results.
+struct CpuKernels {
+    CpuIsa isa;
+    const char* name;
+
+    // Bilinear gather of one output row into NCHW float planes (BGR(A) source -> RGB planes),
+    // wy0/wy1 already carrying the pixel normalization
+    void (*bilinear_row_planar)(const uint8_t* row0, const uint8_t* row1, const int* x0_offsets, const int* x1_offsets,
+                                const float* x_weights, float wy0, float wy1, int width,
+                                float* b_out, float* g_out, float* r_out);
+    // Same gather into packed uint8 BGR (alpha dropped)
+    void (*bilinear_row_bgr)(const uint8_t* row0, const uint8_t* row1, const int* x0_offsets, const int* x1_offsets,
+                             const float* x_weights, float wy0, float wy1, int width, uint8_t* out);
+    // Writes the indices of scores > threshold to `indices` (room for count entries), returns how many
+    int (*scan_scores)(const float* scores, int count, float threshold, int* indices);
+    // Per box best class over channel-major planes [num_classes][num_boxes]; ties keep the lower class
+    void (*class_argmax)(const float* planes, int num_classes, int num_boxes, float* best_score, int* best_class);
+    // Marks suppressed[j] for j in [begin, end) when IoU(kept, j) > threshold (and classes match, if given)
+    void (*suppress_overlaps)(const BoxArrays& boxes, int kept, int begin, int end, float threshold, uint8_t* suppressed);
+    // Sum of count bytes
+    uint32_t (*sum_bytes)(const uint8_t* data, size_t count);
+};
+
+// Variant tables, defined by src/cpu_kernels_<isa>.cpp
+const CpuKernels& cpu_kernels_generic();
+#ifdef DOGAI_X86_KERNELS
+const CpuKernels& cpu_kernels_sse42();
+const CpuKernels& cpu_kernels_avx2();
+const CpuKernels& cpu_kernels_avx512();
+#endif
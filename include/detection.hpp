@@ -0,0 +1,70 @@
+#pragma once
+
+#include "span.hpp"
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+// One detection in source image pixels: float corners, score and class, nothing derived.
+struct Detection {
+    float x1 = 0.0f;
+    float y1 = 0.0f;
+    float x2 = 0.0f;
+    float y2 = 0.0f;
+    float score = 0.0f;
+    int class_id = 0;
+
+    float width() const { return x2 - x1; }
+    float height() const { return y2 - y1; }
+    float area() const { return (x2 - x1) * (y2 - y1); }
+    cv::Point2f center() const { return cv::Point2f((x1 + x2) * 0.5f, (y1 + y2) * 0.5f); }
+    // Integer box for drawing (corners truncated)
+    cv::Rect rect() const {
+        return cv::Rect(cv::Point(static_cast<int>(x1), static_cast<int>(y1)), cv::Point(static_cast<int>(x2), static_cast<int>(y2)));
+    }
+    void translate(float dx, float dy) {
+        x1 += dx;
+        x2 += dx;
+        y1 += dy;
+        y2 += dy;
+    }
+};
+static_assert(sizeof(Detection) == 24, "Detection must stay a compact 24-byte record");
+
+// Position of a detection relative to the FOV. Only computed for consumers that ask for it
+// (FOVProcessor::compute_metrics), in one pass over the frame's detections.
+struct FovMetrics {
+    cv::Point2f center;                // Center relative to the FOV (0-1)
+    float distance = 0.0f;             // From the FOV center (0-1)
+    float angle = 0.0f;                // From the FOV center, radians
+};
+
+// A frame's results as downstream stages see them: views into the producer's arena,
+// valid until the producer starts its next frame. fov is empty or parallel to detections.
+struct FrameDetections {
+    Span<const Detection> detections;
+    Span<const FovMetrics> fov;
+
+    size_t size() const { return detections.size(); }
+    bool empty() const { return detections.empty(); }
+};
+
+// Per-frame result arena. The decoder, NMS and derived-metric passes rewrite these
+// buffers in place every frame and their capacity is kept, so result handling
+// neither allocates nor copies in steady state.
+class DetectionArena {
+private:
+    std::vector<Detection> detection_buffer;
+    std::vector<FovMetrics> fov_buffer;
+
+public:
+    // Producer side
+    std::vector<Detection>& detections() { return detection_buffer; }
+    std::vector<FovMetrics>& fov() { return fov_buffer; }
+    void clear() {
+        detection_buffer.clear();
+        fov_buffer.clear();
+    }
+
+    // Consumer side
+    FrameDetections view() const { return FrameDetections{detection_buffer, fov_buffer}; }
+};
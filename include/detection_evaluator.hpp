@@ -0,0 +1,73 @@
+#pragma once
+
+#include "detection.hpp"
+#include "span.hpp"
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+struct ClassAccuracy {
+    int class_id = 0;
+    int ground_truth = 0;              // Labeled objects
+    int predictions = 0;
+    double ap50 = 0.0;                 // AP at IoU 0.5
+    double ap50_95 = 0.0;              // Mean AP over IoU 0.50:0.05:0.95
+    double precision = 0.0;            // At IoU 0.5 over every prediction kept by the detector
+    double recall = 0.0;
+};
+
+struct AccuracyReport {
+    std::vector<ClassAccuracy> classes;    // Classes with labels or predictions, by class id
+    double map50 = 0.0;                    // Means over classes with labels
+    double map50_95 = 0.0;
+    int64_t images = 0;
+};
+
+// COCO-style detection accuracy. Each image's predictions are matched to its
+// labels once per IoU threshold (greedy by score, same class, best IoU first),
+// and only the per-prediction outcome is kept, so evaluators filled by
+// different threads are merged cheaply before evaluate(). AP uses the 101-point
+// interpolated precision envelope.
+class DetectionEvaluator {
+public:
+    static constexpr int NUM_IOU_THRESHOLDS = 10;   // 0.50, 0.55, ... 0.95
+
+private:
+    struct Outcome {
+        float score;
+        int class_id;
+        uint16_t true_positive;        // Bit t: matched at IoU threshold t
+    };
+
+    std::vector<Outcome> outcomes;
+    std::map<int, int> ground_truth_counts;
+    int64_t images = 0;
+
+    // add_image scratch
+    std::vector<int> order;
+    std::vector<float> ious;
+    std::vector<uint8_t> matched;
+
+public:
+    DetectionEvaluator() = default;
+
+    void add_image(Span<const Detection> predictions, Span<const Detection> ground_truth);
+    void merge(const DetectionEvaluator& other);
+    AccuracyReport evaluate() const;
+
+    static float iou_threshold(int index) { return 0.5f + 0.05f * index; }
+
+    // YOLO label file: one "class cx cy w h" line per object, normalized to the image size
+    // (polygon lines "class x1 y1 x2 y2 ..." use their bounding box). A missing file means
+    // no objects; false only when the file exists but cannot be parsed.
+    static bool load_yolo_labels(const std::string& path, const cv::Size& image_size, std::vector<Detection>& labels);
+    // images/<name>.jpg -> labels/<name>.txt (last "images" directory swapped), or
+    // <labels_dir>/<stem>.txt when a labels directory is given
+    static std::string label_path_for(const std::string& image_path, const std::string& labels_dir = "");
+
+private:
+    static double average_precision(std::vector<const Outcome*>& sorted, int ground_truth, int threshold,
+                                    double* precision = nullptr, double* recall = nullptr);
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "config_manager.hpp"
+#include "detection_workspace.hpp"
+#include "frame_source.hpp"
+#include "logger.hpp"
+#include "work_stealing_pool.hpp"
+#include "yolov8_model.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+struct StreamReport {
+    std::string name;
+    int64_t frames = 0;
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+struct ServerReport {
+    std::vector<StreamReport> streams;
+    int64_t total_frames = 0;
+    double wall_seconds = 0.0;
+    double throughput_fps = 0.0;
+    uint64_t steals = 0;
+};
+
+// Processes several frame sources in one process: a pool of ORT sessions
+// (or one session with concurrent Run), one DetectionWorkspace per worker and
+// a work-stealing scheduler. Each stream has at most one frame in flight, so
+// sources are never grabbed concurrently and per-stream order is preserved.
+class DetectionServer {
+private:
+    struct Stream {
+        std::string name;
+        std::unique_ptr<FrameSource> source;
+        cv::Rect region;
+        int64_t max_frames = -1;
+        Frame frame;
+        std::vector<Detection> detections;     // Reused frame to frame
+        int64_t frames = 0;
+        std::vector<double> latencies_ms;
+    };
+
+    ConfigManager config;
+    std::vector<std::shared_ptr<YOLOv8Model>> sessions;
+    std::vector<std::unique_ptr<DetectionWorkspace>> workspaces;
+    std::vector<std::unique_ptr<Stream>> streams;
+    std::unique_ptr<WorkStealingPool> pool;
+    size_t first_session_bytes = 0;        // Creating the first session, before warmup
+    size_t additional_session_bytes = 0;   // Mean per later session; includes every session's warmup buffers
+    Logger logger;
+
+public:
+    // Values <= 0 fall back to [Server] in blood.cfg, an empty backend to [Model] backend
+    DetectionServer(const std::string& model_path, int num_workers = 0, int num_sessions = 0,
+                    const std::string& backend = "");
+    ~DetectionServer() = default;
+
+    // region: area grabbed from each frame (empty = full frame); max_frames < 0 = until the source ends
+    void add_stream(const std::string& name, std::unique_ptr<FrameSource> source,
+                    const cv::Rect& region = cv::Rect(), int64_t max_frames = -1);
+    // Runs every stream to completion
+    ServerReport run();
+
+    int get_num_workers() const { return static_cast<int>(workspaces.size()); }
+    int get_num_sessions() const { return static_cast<int>(sessions.size()); }
+    const char* get_backend_name() const { return sessions.front()->get_backend_name(); }
+    // RSS growth while creating the sessions ([Memory] share_weights / shared_arena shrink the second).
+    // The additional figure is an upper bound: warmups overlap creation and are counted in it
+    size_t get_first_session_bytes() const { return first_session_bytes; }
+    size_t get_additional_session_bytes() const { return additional_session_bytes; }
+
+private:
+    void process_next(Stream& stream, int worker_id);
+};
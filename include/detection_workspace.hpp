@@ -0,0 +1,41 @@
+#pragma once
+
+#include "config_manager.hpp"
+#include "yolov8_model.hpp"
+#include "yolov8_preprocessor.hpp"
+#include "yolov8_postprocessor.hpp"
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <vector>
+
+// Wall time of each stage of the last detection
+struct DetectionTimings {
+    double preprocess_ms = 0.0;
+    double inference_ms = 0.0;
+    double postprocess_ms = 0.0;
+    double gate_ms = 0.0;          // Cascade gate, when enabled
+};
+
+// Per-thread preprocessing and postprocessing state around a (possibly shared) model.
+// A workspace is used by one thread at a time; YOLOv8Model::run_inference may be
+// called concurrently from several workspaces. When a different model is passed in
+// (hot swap), the input size and thresholds are re-resolved before the frame runs.
+class DetectionWorkspace {
+private:
+    YOLOv8Preprocessor preprocessor;
+    YOLOv8Postprocessor postprocessor;
+    DetectionTimings last_timings;
+    uint64_t bound_model_id = 0;       // Model the input size and thresholds were taken from
+
+public:
+    DetectionWorkspace(const YOLOv8Model& model, ConfigManager& config);
+    ~DetectionWorkspace() = default;
+
+    // Results are written into `detections` (cleared first, capacity kept)
+    void detect(YOLOv8Model& model, const cv::Mat& image, std::vector<Detection>& detections);
+    const DetectionTimings& get_last_timings() const { return last_timings; }
+    YOLOv8Postprocessor& get_postprocessor() { return postprocessor; }
+
+private:
+    void bind(const YOLOv8Model& model);
+};
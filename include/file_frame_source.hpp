@@ -0,0 +1,49 @@
+#pragma once
+
+#include "frame_source.hpp"
+#include "logger.hpp"
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// File-backed frame source: a single image, a directory of images or a video file.
+// Decoded frames are BGR; BGRA output emulates the screen capture layout.
+class FileFrameSource : public FrameSource {
+private:
+    std::vector<std::string> image_paths;
+    size_t next_image = 0;
+    cv::VideoCapture video;
+    bool is_video = false;
+    bool loop = false;
+    bool opened = false;
+    PixelFormat output_format = PixelFormat::BGR;
+    cv::Mat current;                 // Last decoded frame in output_format
+    cv::Mat decoded;
+    cv::Size source_size;
+    int64_t frame_counter = 0;
+    Logger logger;
+
+public:
+    FileFrameSource(const std::string& path, bool loop_frames = false, PixelFormat format = PixelFormat::BGR);
+    ~FileFrameSource() override = default;
+
+    bool is_open() const override { return opened; }
+    cv::Size get_source_size() const override { return source_size; }
+    bool grab(const cv::Rect& region, Frame& frame) override;
+    // Image lists seek by position. Videos either land exactly on frame_index or return
+    // false with the decoder left where it was (keyframe-only codecs)
+    bool seek(int64_t frame_index) override;
+
+    PixelFormat get_output_format() const { return output_format; }
+    // Number of frames, or -1 when unknown
+    int64_t get_frame_count() const override;
+
+private:
+    bool decode_next(int64_t& timestamp_us);
+    static bool is_image_file(const std::string& path);
+};
+
+// Opens a raw container (.raw) or any image/video path as a frame source
+std::unique_ptr<FrameSource> open_file_frame_source(const std::string& path, bool loop_frames = false,
+                                                    PixelFormat format = PixelFormat::BGR);
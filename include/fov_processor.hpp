@@ -1,6 +1,6 @@
 #pragma once
 
-#include "yolov8_postprocessor.hpp"
+#include "detection.hpp"
 #include <opencv2/opencv.hpp>
 #include <vector>
 #include <cmath>
@@ -17,9 +17,10 @@ public:
     
     void set_fov_size(int width, int height);
     cv::Size get_fov_size() const;
-    std::vector<Detection> process_fov_detections(const std::vector<Detection>& detections);
-    cv::Point2f calculate_fov_center(const cv::Rect& box) const;
+    // One pass over the frame's detections; `metrics` is resized to match (capacity kept)
+    void compute_metrics(Span<const Detection> detections, std::vector<FovMetrics>& metrics) const;
+    cv::Point2f calculate_fov_center(const Detection& detection) const;
     float calculate_fov_distance(const cv::Point2f& center) const;
     float calculate_fov_angle(const cv::Point2f& center) const;
-    void calculate_fov_metrics(Detection& detection);
-}; 
\ No newline at end of file
+    FovMetrics calculate_fov_metrics(const Detection& detection) const;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "config_manager.hpp"
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+struct FrameChangeOptions {
+    bool enabled = false;
+    int grid = 16;                     // Fingerprint is grid x grid block sums
+    float threshold = 2.0f;            // Max mean change of any block (0-255 scale) still counted as unchanged
+    int max_reuse_frames = 1;          // Consecutive frames that may reuse one result
+    int max_reuse_ms = 100;            // Age limit of a reused result
+};
+
+struct FrameChangeStats {
+    uint64_t frames = 0;
+    uint64_t reused = 0;               // Frames answered with the previous detections
+    uint64_t changed = 0;              // Frames whose fingerprint moved past the threshold
+    uint64_t expired = 0;              // Unchanged frames re-detected because of the reuse limits
+};
+
+// Cheap per-frame fingerprint (block sums from the dispatched SAD kernel) used to skip
+// inference on frames that did not change since the last detected one. Frames
+// are compared against the frame that produced the cached result, not the
+// previous frame, so slow drifts still trigger a new detection.
+class FrameChangeDetector {
+private:
+    FrameChangeOptions options;
+    FrameChangeStats stats;
+
+    cv::Size geometry_size;
+    int geometry_channels = 0;
+    std::vector<int> column_bounds;    // Byte offsets of the grid columns, grid + 1 entries
+    std::vector<int> row_block;        // Grid row of every image row
+    std::vector<uint32_t> max_block_delta;  // threshold * pixels-per-block, per block
+
+    std::vector<uint32_t> current;
+    std::vector<uint32_t> reference;
+    bool current_valid = false;
+    bool has_reference = false;
+    int reuse_count = 0;
+    std::chrono::steady_clock::time_point reference_time;
+
+public:
+    explicit FrameChangeDetector(const FrameChangeOptions& change_options);
+    ~FrameChangeDetector() = default;
+
+    // Fingerprints the frame; true when the previous result may be reused
+    bool can_reuse(const cv::Mat& image);
+    // The frame passed to the last can_reuse was detected: it becomes the reference
+    void commit();
+    // Drops the reference: the next frame is always detected (e.g. after a model swap)
+    void reset() { has_reference = false; }
+
+    const FrameChangeStats& get_stats() const { return stats; }
+    const FrameChangeOptions& get_options() const { return options; }
+
+    // [Capture] enable_frame_skip, frame_skip_ratio and frame_skip_* keys
+    static FrameChangeOptions options_from_config(ConfigManager& config);
+
+private:
+    void build_geometry(const cv::Size& size, int channels);
+    void compute_fingerprint(const cv::Mat& image);
+};
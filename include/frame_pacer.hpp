@@ -0,0 +1,74 @@
+#pragma once
+
+#include "config_manager.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+enum class PacingMode {
+    Deadline,   // Frames end on an absolute schedule of 1 / target_fps
+    Unpaced     // No waiting at all (benchmarks, capture-bound setups)
+};
+
+struct FramePacingOptions {
+    PacingMode mode = PacingMode::Deadline;
+    int target_fps = 120;
+    int spin_us = 1000;                // Last stretch before a deadline is spun instead of slept
+    int max_lag_frames = 2;            // Further behind than this, the schedule restarts instead of bursting
+};
+
+struct FramePacingStats {
+    uint64_t frames = 0;
+    uint64_t missed = 0;               // Frames that finished after their deadline
+    uint64_t resyncs = 0;              // Schedule restarts after falling max_lag_frames behind
+    double max_late_ms = 0.0;          // Worst finish past a missed deadline
+    double wait_ms_total = 0.0;        // Time spent waiting for deadlines
+    double max_overshoot_ms = 0.0;     // Worst wake-up past a deadline that was waited for
+};
+
+// Paces a frame loop against absolute deadlines (deadline += period) rather
+// than sleeping "period - frame time", so timer overshoot on one frame is
+// absorbed by the next one instead of accumulating. The wait sleeps on the OS
+// timer until spin_us before the deadline (a high-resolution waitable timer on
+// Windows) and spins out the rest, which keeps wake-up jitter well under the
+// scheduler tick.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    FramePacingOptions options;
+    FramePacingStats stats;
+    Clock::duration period{};
+    Clock::duration spin{};
+    Clock::time_point deadline;
+    bool started = false;
+#ifdef _WIN32
+    void* timer = nullptr;
+#endif
+
+public:
+    explicit FramePacer(const FramePacingOptions& pacing_options);
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // Called once per frame after its work: waits for the frame's deadline and
+    // schedules the next one. False when the deadline had already passed.
+    bool wait();
+    // The next wait() starts a new schedule (e.g. after a pause)
+    void reset() { started = false; }
+
+    bool is_paced() const { return options.mode == PacingMode::Deadline; }
+    const FramePacingOptions& get_options() const { return options; }
+    const FramePacingStats& get_stats() const { return stats; }
+    // "120" or "unpaced", for FPS overlays and logs
+    std::string describe_target() const;
+
+    // [Performance] target_fps, frame_pacing, pacing_spin_us, pacing_max_lag_frames
+    static FramePacingOptions options_from_config(ConfigManager& config);
+
+private:
+    void sleep_until(Clock::time_point wake);
+};
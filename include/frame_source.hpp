@@ -0,0 +1,60 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+// Native pixel layout of a captured frame
+enum class PixelFormat {
+    BGR,
+    BGRA
+};
+
+inline int pixel_format_channels(PixelFormat format) {
+    return format == PixelFormat::BGRA ? 4 : 3;
+}
+
+struct Frame {
+    cv::Mat image;                         // Pixels of `region` only (CV_8UC3 or CV_8UC4), may view source memory
+    PixelFormat format = PixelFormat::BGR;
+    cv::Rect region;                       // Area of the source the pixels came from
+    int64_t frame_id = -1;
+    int64_t timestamp_us = 0;
+};
+
+// Contract between capture and preprocessing: a source copies only the
+// region it was asked for and hands it over in its native pixel format.
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    virtual bool is_open() const = 0;
+    virtual cv::Size get_source_size() const = 0;
+    // Fetch the next frame restricted to `region` (empty region = full frame)
+    virtual bool grab(const cv::Rect& region, Frame& frame) = 0;
+    // Positions the next grab at frame_index; false when the source cannot seek there
+    virtual bool seek(int64_t /*frame_index*/) { return false; }
+    // Frames in a finite source, -1 when unknown or unbounded
+    virtual int64_t get_frame_count() const { return -1; }
+
+    // Region of the given size centered on the source, clamped to its bounds
+    cv::Rect centered_region(int width, int height) const {
+        auto size = get_source_size();
+        auto x = std::max(0, (size.width - width) / 2);
+        auto y = std::max(0, (size.height - height) / 2);
+        return cv::Rect(x, y, std::min(width, size.width - x), std::min(height, size.height - y));
+    }
+
+protected:
+    static int64_t now_us() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Clamp a requested region to the source bounds
+    cv::Rect clamp_region(const cv::Rect& region) const {
+        auto bounds = cv::Rect(cv::Point(0, 0), get_source_size());
+        return region.empty() ? bounds : (region & bounds);
+    }
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class TensorElementType {
+    Float32,    // NCHW, RGB, [0, 1]
+    UInt8       // NHWC, BGR, raw pixels (tools/prepare_uint8_input.py)
+};
+
+// Non-owning view of a float output tensor
+struct TensorView {
+    const float* data = nullptr;
+    std::vector<int64_t> shape;
+
+    size_t element_count() const {
+        auto count = size_t(1);
+        for (auto dim : shape) count *= static_cast<size_t>(dim);
+        return count;
+    }
+};
+
+// Outputs of one inference. The views point into buffers owned by `storage`
+// (ORT values, cv::Mats), so they stay valid as long as this object lives.
+struct InferenceOutput {
+    std::vector<TensorView> tensors;
+    std::shared_ptr<void> storage;
+
+    bool empty() const { return tensors.empty(); }
+    size_t size() const { return tensors.size(); }
+    const TensorView& operator[](size_t index) const { return tensors[index]; }
+};
+
+// One loaded model on one inference engine. The pre/postprocessing around it
+// only sees input sizes and tensor views, so engines can be swapped per
+// deployment ([Model] backend).
+class InferenceBackend {
+public:
+    virtual ~InferenceBackend() = default;
+
+    virtual const char* name() const = 0;
+    virtual TensorElementType input_type() const = 0;
+    // Input size taken from the model when it has a static shape, else from [Model]
+    virtual int input_width() const = 0;
+    virtual int input_height() const = 0;
+
+    // Float NCHW tensor of input_width x input_height
+    virtual InferenceOutput run(const std::vector<float>& input_tensor) = 0;
+    // Continuous input-sized uint8 BGR image
+    virtual InferenceOutput run(const cv::Mat& input_image) = 0;
+
+    // Allocator statistics ("key=value ..."), empty when the engine cannot report them
+    virtual std::string get_arena_stats() { return std::string(); }
+};
+
+// [Memory] sharing between sessions of one process (applied by the ONNX Runtime backend)
+struct SessionMemoryOptions {
+    bool share_weights = true;         // Initializers and prepacked weights loaded once per model file
+    bool layout_optimization = true;   // false: no NCHWc layout rewrite, so conv weights stay shared (slower)
+    bool shared_arena = false;         // One CPU arena for every session; the arena_* settings apply to it
+    int arena_extend_strategy = 0;     // 0 = next power of two, 1 = same as requested
+    size_t arena_max_bytes = 0;        // 0 = no cap
+    int arena_initial_chunk_bytes = -1; // -1 = engine default
+};
+
+// Settings shared by every backend
+struct BackendOptions {
+    int input_width = 640;             // [Model] input_width/height, used when the model shape is dynamic
+    int input_height = 640;
+    int intra_op_threads = 8;
+    SessionMemoryOptions memory;
+};
+
+// "onnxruntime" (default) or "opencv"; throws std::runtime_error for unknown names
+std::unique_ptr<InferenceBackend> create_inference_backend(const std::string& kind, const std::string& model_path,
+                                                           const BackendOptions& options);
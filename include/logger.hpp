@@ -5,6 +5,7 @@
 #include <sstream>
 #include <iomanip>
 #include <chrono>
+#include <mutex>
 #include <string>
 
 // Enum para níveis de log
@@ -20,6 +21,7 @@ class Logger {
 private:
     std::ofstream log_file;
     LogLevel current_level = LogLevel::ERROR; // Default: only errors
+    std::mutex write_mutex;                   // Loggers are shared by worker threads
     
     std::string get_timestamp() {
         auto now = std::chrono::system_clock::now();
@@ -43,6 +45,7 @@ private:
     
     void write_log(LogLevel level, const std::string& message) {
         if (level >= current_level) {
+            std::lock_guard<std::mutex> lock(write_mutex);
             std::string timestamp = get_timestamp();
             std::string level_str = level_to_string(level);
             std::string log_message = "[" + timestamp + "] [" + level_str + "] " + message;
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "config_manager.hpp"
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Pipeline stage that allocations are attributed to (per thread)
+enum class PipelineStage {
+    Other,
+    Capture,
+    Gate,
+    Preprocess,
+    Inference,
+    Postprocess,
+    Render,
+    Output,
+    Count
+};
+
+const char* pipeline_stage_name(PipelineStage stage);
+
+// Opt-in allocation tracking ([Debug] enable_memory_tracking). When enabled,
+// operator new and a cv::MatAllocator wrapper add every allocation to the
+// stage set by the innermost StageScope on the allocating thread. Disabled,
+// the hooks cost one relaxed load.
+class MemoryTracker {
+public:
+    struct StageCounters {
+        uint64_t allocations = 0;      // operator new
+        uint64_t bytes = 0;
+        uint64_t mat_allocations = 0;  // cv::Mat buffers (fastMalloc, bypasses operator new)
+        uint64_t mat_bytes = 0;
+    };
+    using Snapshot = std::array<StageCounters, static_cast<size_t>(PipelineStage::Count)>;
+
+    static void configure(ConfigManager& config);
+    static void enable();
+    static bool is_enabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Called from the allocation hooks
+    static void record_allocation(size_t size);
+    static void record_mat_allocation(size_t size);
+
+    static PipelineStage current_stage();
+    static void set_current_stage(PipelineStage stage);
+
+    static void snapshot(Snapshot& out);
+    // Per-stage allocations per frame between two snapshots, plus peak RSS
+    static std::string format_report(const Snapshot& previous, const Snapshot& current, uint64_t frames);
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+// Attributes allocations on this thread to a stage for the scope's lifetime
+class StageScope {
+private:
+    PipelineStage previous;
+
+public:
+    explicit StageScope(PipelineStage stage) : previous(MemoryTracker::current_stage()) {
+        MemoryTracker::set_current_stage(stage);
+    }
+    ~StageScope() { MemoryTracker::set_current_stage(previous); }
+
+    StageScope(const StageScope&) = delete;
+    StageScope& operator=(const StageScope&) = delete;
+};
+
+// Periodic per-frame report for a frame loop: call on_frame() once per frame
+class MemoryReport {
+private:
+    MemoryTracker::Snapshot previous{};
+    uint64_t frames = 0;
+
+public:
+    MemoryReport() { MemoryTracker::snapshot(previous); }
+    void on_frame() { ++frames; }
+    // Report since the last call (empty when tracking is off or no frame passed)
+    std::string take();
+};
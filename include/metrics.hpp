@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free runtime metrics. The frame path only does relaxed atomic updates;
+// the exporter thread reads them without sharing any lock with it.
+
+class Counter {
+private:
+    std::atomic<uint64_t> value{0};
+
+public:
+    void add(uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+class Gauge {
+private:
+    std::atomic<int64_t> value{0};
+
+public:
+    void set(int64_t v) { value.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { value.fetch_add(n, std::memory_order_relaxed); }
+    int64_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+// Latency distribution in log-spaced buckets (10 us to ~13 s, x1.25 per bucket)
+class LatencySummary {
+public:
+    static constexpr int NUM_BUCKETS = 64;
+    using Snapshot = std::array<uint64_t, NUM_BUCKETS>;
+
+private:
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum_us{0};
+
+public:
+    void observe_ms(double ms);
+
+    uint64_t get_count() const { return count.load(std::memory_order_relaxed); }
+    double get_sum_seconds() const { return sum_us.load(std::memory_order_relaxed) / 1e6; }
+    void snapshot(Snapshot& out) const;
+
+    // Upper bound of bucket i, in seconds
+    static double bucket_upper_seconds(int index);
+    // Quantile over the observations between two snapshots (0 when none)
+    static double quantile_seconds(const Snapshot& previous, const Snapshot& current, double q);
+};
+
+// Every metric the pipeline reports. Fixed members instead of a registry so
+// updates never look anything up.
+struct DetectionMetrics {
+    // Frames
+    Counter frames_in;                 // Submitted to detection
+    Counter frames_out;                // Detection finished
+    Counter frames_reused;             // Answered by the unchanged-frame early-out
+    Counter frames_gated;              // Answered by the cascade gate alone
+    Counter capture_failures;
+    Counter output_dropped;            // Annotated-video writer backpressure
+    Counter render_dropped;            // Render mailbox overwrites
+    Counter model_swaps;               // Hot swaps published
+    Counter model_swap_failures;       // Replacements that failed to load
+    Counter pacing_missed;             // Frames that finished past their pacing deadline
+
+    // Stage latency
+    LatencySummary detect_latency;
+    LatencySummary preprocess_latency;
+    LatencySummary inference_latency;
+    LatencySummary postprocess_latency;
+    LatencySummary gate_latency;
+    LatencySummary ort_run_latency;    // Backend run alone (Session::Run / Net::forward)
+
+    // Queues
+    Gauge async_in_flight;
+    Gauge output_queue_depth;
+};
+
+DetectionMetrics& detection_metrics();
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "logger.hpp"
+#include "metrics.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Serves detection_metrics() in Prometheus text format on its own thread.
+// listen: "127.0.0.1:9464" (TCP, loopback only) or "unix:/path/to.sock" (POSIX).
+// Latency quantiles are computed over the interval since the previous scrape.
+class MetricsExporter {
+private:
+    std::string listen_address;
+    std::atomic<bool> stopping{false};
+    std::thread server_thread;
+    intptr_t listen_socket = -1;
+    std::string unix_path;
+
+    // Scrape-to-scrape state, owned by the exporter thread
+    std::vector<LatencySummary::Snapshot> previous_snapshots;
+    uint64_t previous_allocations = 0;
+    uint64_t previous_frames = 0;
+    Logger logger;
+
+public:
+    explicit MetricsExporter(const std::string& address);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    bool is_running() const { return listen_socket != -1; }
+    // Prometheus exposition text; advances the scrape-to-scrape state
+    std::string render();
+
+private:
+    bool open_socket();
+    void close_socket();
+    void serve_loop();
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "yolov8_model.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// The model currently serving frames. Readers take a reference per frame, so a
+// replacement can be published between frames while in-flight frames finish on
+// the model they started with; the old session is freed when the last of them
+// drops its reference.
+class ModelSlot {
+private:
+    std::shared_ptr<YOLOv8Model> current;   // Accessed through std::atomic_load/atomic_store only
+    std::atomic<uint64_t> generation{0};
+
+public:
+    explicit ModelSlot(std::shared_ptr<YOLOv8Model> model);
+    ~ModelSlot() = default;
+
+    ModelSlot(const ModelSlot&) = delete;
+    ModelSlot& operator=(const ModelSlot&) = delete;
+
+    // Keep the returned reference for the whole frame
+    std::shared_ptr<YOLOv8Model> acquire() const;
+    // Publishes `model` for the next acquire and returns the previous one
+    std::shared_ptr<YOLOv8Model> exchange(std::shared_ptr<YOLOv8Model> model);
+    // Number of swaps so far
+    uint64_t get_generation() const { return generation.load(std::memory_order_acquire); }
+};
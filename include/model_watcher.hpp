@@ -0,0 +1,51 @@
+#pragma once
+
+#include "config_manager.hpp"
+#include "logger.hpp"
+#include "yolov8_detector.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct ModelWatchOptions {
+    bool enabled = false;
+    std::string config_path = "blood.cfg";
+    int interval_ms = 1000;            // Poll period; a change must stay put for one period before it is loaded
+};
+
+// Polls blood.cfg [Model] model_path and the model file's modification time on its
+// own thread and asks the detector to hot swap when either changes, so retrained
+// models roll out without restarting the process.
+class ModelWatcher {
+private:
+    YOLOv8& detector;
+    ModelWatchOptions options;
+    std::string model_path;
+    std::filesystem::file_time_type model_time;
+    std::string candidate_path;        // Change seen on the last poll, waiting to settle
+    std::filesystem::file_time_type candidate_time;
+
+    std::mutex stop_mutex;
+    std::condition_variable stop_signal;
+    bool stopping = false;
+    std::thread watch_thread;
+    Logger logger;
+
+public:
+    ModelWatcher(YOLOv8& watched_detector, const std::string& current_model_path, const ModelWatchOptions& watch_options);
+    ~ModelWatcher();
+
+    ModelWatcher(const ModelWatcher&) = delete;
+    ModelWatcher& operator=(const ModelWatcher&) = delete;
+
+    // [Model] hot_reload / hot_reload_interval_ms
+    static ModelWatchOptions options_from_config(ConfigManager& config);
+
+private:
+    void watch_loop();
+    void poll();
+    static bool modification_time(const std::string& path, std::filesystem::file_time_type& time);
+};
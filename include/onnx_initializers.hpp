@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One graph initializer stored inline (TensorProto.raw_data) in a serialized ONNX model
+struct OnnxInitializer {
+    std::string name;
+    int32_t data_type = 0;             // TensorProto.DataType; ONNXTensorElementDataType uses the same values
+    std::vector<int64_t> dims;
+    const uint8_t* data = nullptr;     // Points into the model buffer
+    size_t size = 0;
+};
+
+// Minimal protobuf walk over ModelProto.graph.initializer: no ONNX or protobuf dependency.
+// Tensors kept in typed fields (float_data, ...) or in external files are skipped, as are
+// subgraph initializers. False when the buffer is not a well-formed model.
+bool read_onnx_initializers(const uint8_t* data, size_t size, std::vector<OnnxInitializer>& initializers);
+
+// Bytes per element of a fixed-size TensorProto.DataType, 0 for strings and unknown types
+size_t onnx_element_size(int32_t data_type);
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "inference_backend.hpp"
+#include "logger.hpp"
+#include <onnxruntime_cxx_api.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Weights of one version of a model file, shared by all its sessions: the initializers
+// (one aligned copy, handed to each session as external initializers so ORT does not keep
+// its own) and the prepacked-weights container for kernels that implement PrePack.
+struct SharedModelWeights {
+    Ort::PrepackedWeightsContainer prepacked;
+    std::vector<uint8_t> storage;
+    std::vector<std::string> initializer_names;
+    std::vector<Ort::Value> initializers;     // Views over `storage`
+    size_t initializer_bytes = 0;
+};
+
+// Process-wide ONNX Runtime state shared by every session: one Env, optionally one
+// CPU arena registered on it, and the weights of each model file so additional sessions
+// of a model (workers, gate, swaps) do not load them again.
+// Settings of the first session win; it lives while any session holds it.
+class OnnxRuntimeEnvironment {
+private:
+    Ort::Env env;
+    bool arena_registered = false;
+    std::mutex weights_mutex;
+    std::map<std::string, std::weak_ptr<SharedModelWeights>> weights;
+    Logger logger;
+
+public:
+    explicit OnnxRuntimeEnvironment(const SessionMemoryOptions& options);
+
+    static std::shared_ptr<OnnxRuntimeEnvironment> acquire(const SessionMemoryOptions& options);
+
+    Ort::Env& get_env() { return env; }
+    bool has_shared_arena() const { return arena_registered; }
+    // Weights for one version of a model file (path, size and modification time). The
+    // initializers are read from `model_data` by the first caller; without it, or when it
+    // cannot be parsed, only prepacked weights are shared.
+    std::shared_ptr<SharedModelWeights> weights_for(const std::string& model_path, const uint8_t* model_data, size_t model_size);
+
+private:
+    void load_initializers(SharedModelWeights& shared, const std::string& model_path, const uint8_t* model_data, size_t model_size);
+};
+
+// ONNX Runtime CPU session. Run is safe to call concurrently.
+class OnnxRuntimeBackend : public InferenceBackend {
+private:
+    // Declared before the session: both must outlive it
+    std::shared_ptr<OnnxRuntimeEnvironment> environment;
+    std::shared_ptr<SharedModelWeights> shared_weights;
+    Ort::Session session{nullptr};
+    std::vector<std::string> input_names;
+    std::vector<std::string> output_names;
+    std::vector<const char*> input_names_char;
+    std::vector<const char*> output_names_char;
+    int width = 640;
+    int height = 640;
+    ONNXTensorElementDataType element_type = ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+    Logger logger;
+
+public:
+    OnnxRuntimeBackend(const std::string& model_path, const BackendOptions& options);
+    ~OnnxRuntimeBackend() override = default;
+
+    const char* name() const override { return "onnxruntime"; }
+    TensorElementType input_type() const override;
+    int input_width() const override { return width; }
+    int input_height() const override { return height; }
+
+    InferenceOutput run(const std::vector<float>& input_tensor) override;
+    InferenceOutput run(const cv::Mat& input_image) override;
+
+    // CPU arena statistics ("InUse=... MaxInUse=..."), needs ORT_API_VERSION >= 22
+    std::string get_arena_stats() override;
+
+private:
+    void initialize(const std::string& model_path, const BackendOptions& options);
+    InferenceOutput run_session(const Ort::Value& input);
+};
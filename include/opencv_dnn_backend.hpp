@@ -0,0 +1,31 @@
+#pragma once
+
+#include "inference_backend.hpp"
+#include "logger.hpp"
+#include <mutex>
+#include <string>
+#include <vector>
+
+// OpenCV DNN CPU backend (cv::dnn::Net). Float NCHW models only. A Net keeps
+// per-layer state between setInput and forward, so runs are serialized.
+class OpenCvDnnBackend : public InferenceBackend {
+private:
+    cv::dnn::Net net;
+    std::vector<std::string> output_names;
+    int width = 640;
+    int height = 640;
+    std::mutex run_mutex;
+    Logger logger;
+
+public:
+    OpenCvDnnBackend(const std::string& model_path, const BackendOptions& options);
+    ~OpenCvDnnBackend() override = default;
+
+    const char* name() const override { return "opencv"; }
+    TensorElementType input_type() const override { return TensorElementType::Float32; }
+    int input_width() const override { return width; }
+    int input_height() const override { return height; }
+
+    InferenceOutput run(const std::vector<float>& input_tensor) override;
+    InferenceOutput run(const cv::Mat& input_image) override;
+};
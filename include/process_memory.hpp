@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Resident set size of this process, in bytes (0 if unavailable)
+size_t current_rss_bytes();
+size_t peak_rss_bytes();
+
+// Heap allocations made through operator new while MemoryTracker is enabled
+uint64_t allocation_count();
+uint64_t allocated_bytes();
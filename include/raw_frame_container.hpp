@@ -0,0 +1,113 @@
+#pragma once
+
+#include "frame_source.hpp"
+#include "logger.hpp"
+#include "mapped_file.hpp"
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Raw frame container (.raw) for replay without decoding:
+//   RawFrameHeader                          64 bytes
+//   padding up to data_offset               frames start page aligned
+//   frame_count frames of frame_stride      rows packed with row_stride bytes
+//   frame_count int64 timestamps (us)       at timestamps_offset
+struct RawFrameHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;             // PixelFormat
+    uint32_t row_stride;
+    uint32_t reserved;
+    uint64_t frame_stride;
+    uint64_t frame_count;
+    uint64_t data_offset;
+    uint64_t timestamps_offset;
+};
+static_assert(sizeof(RawFrameHeader) == 64, "RawFrameHeader must stay 64 bytes");
+
+constexpr char RAW_FRAME_MAGIC[8] = {'D', 'O', 'G', 'R', 'A', 'W', '0', '1'};
+constexpr uint32_t RAW_FRAME_VERSION = 1;
+constexpr uint64_t RAW_FRAME_ALIGNMENT = 4096;
+
+// Appends frames to a raw container. Geometry and format come from the first frame.
+class RawFrameRecorder {
+private:
+    std::ofstream file;
+    std::string path;
+    RawFrameHeader header = {};
+    std::vector<int64_t> timestamps;
+    std::vector<char> padding;
+    Logger logger;
+
+public:
+    RawFrameRecorder() = default;
+    explicit RawFrameRecorder(const std::string& output_path) { open(output_path); }
+    ~RawFrameRecorder() { close(); }
+
+    bool open(const std::string& output_path);
+    bool write(const Frame& frame);
+    // Writes the timestamp table and final header
+    void close();
+
+    bool is_open() const { return file.is_open(); }
+    uint64_t get_frame_count() const { return header.frame_count; }
+};
+
+// Records every frame grabbed from the wrapped source
+class RecordingFrameSource : public FrameSource {
+private:
+    FrameSource& source;
+    RawFrameRecorder& recorder;
+
+public:
+    RecordingFrameSource(FrameSource& inner, RawFrameRecorder& output) : source(inner), recorder(output) {}
+
+    bool is_open() const override { return source.is_open(); }
+    cv::Size get_source_size() const override { return source.get_source_size(); }
+    bool grab(const cv::Rect& region, Frame& frame) override {
+        if (!source.grab(region, frame)) {
+            return false;
+        }
+        recorder.write(frame);
+        return true;
+    }
+};
+
+// Replays a raw container through mmap; frames are zero-copy, read-only views
+class RawFrameSource : public FrameSource {
+private:
+    MappedFile mapped;
+    RawFrameHeader header = {};
+    const int64_t* timestamps = nullptr;
+    uint64_t next_frame = 0;
+    bool loop = false;
+    bool opened = false;
+    Logger logger;
+
+public:
+    explicit RawFrameSource(const std::string& path, bool loop_frames = false);
+    ~RawFrameSource() override = default;
+
+    bool is_open() const override { return opened; }
+    cv::Size get_source_size() const override {
+        return cv::Size(static_cast<int>(header.width), static_cast<int>(header.height));
+    }
+    bool grab(const cv::Rect& region, Frame& frame) override;
+
+    PixelFormat get_format() const { return static_cast<PixelFormat>(header.format); }
+    int64_t get_frame_count() const override { return static_cast<int64_t>(header.frame_count); }
+    bool seek(int64_t frame_index) override;
+    // Zero-copy view of one frame
+    cv::Mat frame_view(uint64_t frame_index) const;
+
+    static bool is_raw_file(const std::string& path);
+
+private:
+    // Header checks: strides cover the rows, frames and timestamps lie inside the file
+    bool geometry_valid() const;
+    bool layout_fits(uint64_t file_size) const;
+};
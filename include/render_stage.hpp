@@ -0,0 +1,64 @@
+#pragma once
+
+#include "yolov8_postprocessor.hpp"
+#include "yolov8_visualizer.hpp"
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Draws (frame, detections) pairs into frame buffers owned by the stage and
+// shows them. Threaded mode uses a latest-wins mailbox (triple buffering):
+// submit() copies the frame and returns immediately, frames the render thread
+// could not keep up with are dropped instead of stalling inference. The render
+// thread owns the window, so imshow/pollKey also leave the inference thread.
+class RenderStage {
+private:
+    struct Slot {
+        cv::Mat image;
+        std::vector<Detection> detections;
+        std::vector<FovMetrics> fov;
+        std::string overlay;
+    };
+
+    YOLOv8Visualizer visualizer;
+    std::string window_name;
+    cv::Size fov_size;
+    bool threaded = true;
+
+    std::array<Slot, 3> slots;
+    int write_slot = 0;                // Producer side
+    int pending_slot = 1;              // Latest submitted frame
+    int render_slot = 2;               // Render thread side
+    bool has_pending = false;
+    bool stopping = false;
+    std::mutex mailbox_mutex;
+    std::condition_variable frame_available;
+    std::thread render_thread;
+
+    std::atomic<bool> quit{false};
+    std::atomic<uint64_t> rendered{0};
+    std::atomic<uint64_t> dropped{0};
+
+public:
+    RenderStage(const std::string& window, const cv::Size& fov, bool use_thread, const std::string& config_file = "blood.cfg");
+    ~RenderStage();
+
+    RenderStage(const RenderStage&) = delete;
+    RenderStage& operator=(const RenderStage&) = delete;
+
+    // Overlay text is drawn in the top-left corner (FPS line)
+    void submit(const cv::Mat& frame, const FrameDetections& detections, const std::string& overlay);
+    // 'q' pressed in the window
+    bool quit_requested() const { return quit.load(std::memory_order_relaxed); }
+    uint64_t get_rendered_count() const { return rendered.load(std::memory_order_relaxed); }
+    uint64_t get_dropped_count() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    void render(cv::Mat& image, const FrameDetections& detections, const std::string& overlay);
+    void render_loop();
+};
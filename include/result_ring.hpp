@@ -0,0 +1,97 @@
+#pragma once
+
+#include "logger.hpp"
+#include "shared_memory.hpp"
+#include "yolov8_postprocessor.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Shared-memory detection ring. Layout (all offsets fixed at creation):
+//   ResultRingHeader                                   64 bytes
+//   slot_count slots of slot_size bytes, each:
+//     ResultSlotHeader                                 32 bytes
+//     max_detections ResultRecord                      32 bytes each
+// One publisher writes each slot once; any number of readers copy slots out
+// under a seqlock (odd sequence = slot being written), nothing is written by readers.
+struct ResultRingHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t max_detections;
+    uint32_t slot_size;
+    std::atomic<uint64_t> write_index;     // Results published so far
+    uint8_t reserved[32];
+};
+static_assert(sizeof(ResultRingHeader) == 64, "ResultRingHeader must stay 64 bytes");
+
+struct ResultSlotHeader {
+    std::atomic<uint64_t> sequence;        // Seqlock: odd while the publisher writes the slot
+    int64_t frame_id;
+    int64_t timestamp_us;
+    uint32_t count;
+    uint32_t reserved;
+};
+static_assert(sizeof(ResultSlotHeader) == 32, "ResultSlotHeader must stay 32 bytes");
+
+struct ResultRecord {
+    float x, y, width, height;             // Frame pixels
+    float score;
+    int32_t class_id;
+    float fov_distance;
+    float fov_angle;
+};
+static_assert(sizeof(ResultRecord) == 32, "ResultRecord must stay 32 bytes");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared-memory seqlock needs lock-free 64-bit atomics");
+
+constexpr char RESULT_RING_MAGIC[8] = {'D', 'O', 'G', 'R', 'I', 'N', 'G', '1'};
+constexpr uint32_t RESULT_RING_VERSION = 1;
+
+// A result copied out of the ring; records keeps its capacity across reads
+struct RingResult {
+    uint64_t index = 0;                    // Position in the publish order
+    int64_t frame_id = 0;
+    int64_t timestamp_us = 0;
+    std::vector<ResultRecord> records;
+};
+
+class ResultRingPublisher {
+private:
+    SharedMemory memory;
+    ResultRingHeader* header = nullptr;
+    Logger logger;
+
+public:
+    ResultRingPublisher(const std::string& name, uint32_t slot_count = 256, uint32_t max_detections = 64);
+    ~ResultRingPublisher() = default;
+
+    bool is_open() const { return header != nullptr; }
+    // Detections beyond max_detections are dropped (lowest priority: the list is written in order).
+    // FOV fields are 0 when detections.fov is empty.
+    void publish(int64_t frame_id, int64_t timestamp_us, const FrameDetections& detections);
+};
+
+class ResultRingReader {
+private:
+    SharedMemory memory;
+    const ResultRingHeader* header = nullptr;
+    uint64_t cursor = 0;                   // Next index read_next returns
+    uint64_t lost = 0;                     // Results overwritten before this reader got to them
+
+public:
+    ResultRingReader() = default;
+    explicit ResultRingReader(const std::string& name) { open(name); }
+
+    bool open(const std::string& name);
+    bool is_open() const { return header != nullptr; }
+
+    // Next unread result in publish order; false when caught up. Skips ahead if lapped.
+    bool read_next(RingResult& result);
+    // Most recent result, for consumers that only care about the present
+    bool read_latest(RingResult& result);
+    uint64_t get_lost_count() const { return lost; }
+
+private:
+    bool read_slot(uint64_t index, RingResult& result) const;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Named shared-memory segment (POSIX shm_open / Windows named file mapping).
+// The owner creates and sizes it; other processes open it read-only.
+class SharedMemory {
+private:
+    uint8_t* mapped_data = nullptr;
+    size_t mapped_size = 0;
+    std::string segment_name;
+    bool owner = false;
+#ifdef _WIN32
+    void* mapping_handle = nullptr;
+#else
+    int file_descriptor = -1;
+#endif
+
+public:
+    SharedMemory() = default;
+    ~SharedMemory() { close(); }
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    // Creates (or replaces) the segment with the given size, read-write
+    bool create(const std::string& name, size_t size);
+    // Maps an existing segment read-only, with its full size
+    bool open_read_only(const std::string& name);
+    // The owner also removes the name, so a new publisher starts from a clean segment
+    void close();
+
+    bool is_open() const { return mapped_data != nullptr; }
+    uint8_t* data() const { return mapped_data; }
+    size_t size() const { return mapped_size; }
+};
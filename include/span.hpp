@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Non-owning view of contiguous elements (std::span stand-in for C++17).
+// Spans built from containers only bind to lvalues, so they cannot outlive a temporary.
+template<typename T>
+class Span {
+private:
+    T* first = nullptr;
+    size_t count = 0;
+
+public:
+    constexpr Span() = default;
+    constexpr Span(T* data, size_t size) : first(data), count(size) {}
+
+    template<typename Container,
+             typename = std::enable_if_t<std::is_convertible<decltype(std::declval<Container&>().data()), T*>::value>>
+    constexpr Span(Container& container) : first(container.data()), count(container.size()) {}
+
+    // Span<T> -> Span<const T>
+    template<typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(const Span<U>& other) : first(other.data()), count(other.size()) {}
+
+    constexpr T* data() const { return first; }
+    constexpr size_t size() const { return count; }
+    constexpr bool empty() const { return count == 0; }
+    constexpr T& operator[](size_t index) const { return first[index]; }
+    constexpr T* begin() const { return first; }
+    constexpr T* end() const { return first + count; }
+};
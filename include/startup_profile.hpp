@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Wall time of the init steps up to the first detection; steps may be recorded from several threads
+class StartupProfile {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    Clock::time_point origin = Clock::now();
+    mutable std::mutex mutex;
+    std::vector<std::pair<std::string, double>> steps;
+
+public:
+    StartupProfile() = default;
+
+    // Duration of a step that started at `start`
+    void record(const std::string& step, Clock::time_point start);
+    // Time since the profile was created, i.e. since process start for the executables
+    double elapsed_ms() const;
+    // "config 1.2 ms | capture 35.0 ms | ... | total 180.4 ms"
+    std::string format() const;
+};
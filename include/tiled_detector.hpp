@@ -0,0 +1,68 @@
+#pragma once
+
+#include "config_manager.hpp"
+#include "detection_workspace.hpp"
+#include "logger.hpp"
+#include "model_slot.hpp"
+#include "work_stealing_pool.hpp"
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <vector>
+
+struct TilingOptions {
+    bool enabled = false;
+    int tile_size = 0;                 // Tile side in frame pixels (0 = model input width)
+    int overlap = 64;                  // Overlap between neighbouring tiles, in pixels
+    int max_tiles = 16;                // Tiles grow (and get downscaled) to stay under this count
+    int num_workers = 4;
+    bool global_view = true;           // Also run the whole frame downscaled, for large objects
+    float merge_iou_threshold = 0.5f;  // Class-aware NMS across tiles
+};
+
+struct TileReport {
+    cv::Rect region;                   // Whole frame for the global view
+    double total_ms = 0.0;
+    DetectionTimings timings;
+    size_t detections = 0;
+};
+
+// Splits frames larger than the model input into overlapping tiles, runs them in
+// parallel on a work-stealing pool (one workspace per worker, shared model) and
+// merges the per-tile detections in frame coordinates.
+class TiledDetector {
+private:
+    TilingOptions options;
+    std::shared_ptr<ModelSlot> models;
+    bool tile_size_from_model = false; // tile_size follows the model input width across swaps
+    std::unique_ptr<WorkStealingPool> pool;
+    std::vector<std::unique_ptr<DetectionWorkspace>> workspaces;
+    std::vector<cv::Rect> tiles;
+    cv::Size tiles_frame_size;
+    std::vector<std::vector<Detection>> tile_detections;
+    std::vector<TileReport> reports;
+    std::vector<TileReport> accumulated;   // Summed since the tile grid was built
+    uint64_t tiled_frames = 0;
+    YOLOv8Postprocessor merger;
+    Logger logger;
+
+public:
+    TiledDetector(std::shared_ptr<ModelSlot> shared_models, ConfigManager& config, const TilingOptions& tiling_options);
+    ~TiledDetector() = default;
+
+    // Frames that fit in one tile are not worth tiling
+    bool should_tile(const cv::Size& frame_size) const;
+    // Merged detections in frame coordinates, written into `detections`
+    void detect(const cv::Mat& image, std::vector<Detection>& detections);
+
+    // Per-tile cost of the last detect call (global view last, if enabled)
+    const std::vector<TileReport>& get_last_reports() const { return reports; }
+    // Mean per-tile cost over every frame since the tile grid was last rebuilt
+    std::vector<TileReport> get_average_reports() const;
+    const TilingOptions& get_options() const { return options; }
+
+    static TilingOptions options_from_config(ConfigManager& config);
+
+private:
+    void build_tiles(const cv::Size& frame_size);
+    void set_tile_size(int tile_size);
+};
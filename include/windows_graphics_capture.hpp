@@ -1,6 +1,7 @@
 #pragma once
 
 #include "logger.hpp"
+#include "frame_source.hpp"
 #include <opencv2/opencv.hpp>
 #include <windows.h>
 #include <d3d11.h>
@@ -27,7 +28,7 @@ static const GUID IID_IDXGIOutput1_ = { 0x00cddea8, 0x939b, 0x4b83, { 0xa3, 0x40
 #define DXGI_ERROR_ACCESS_LOST_ERROR 0x887A0007
 #endif
 
-class WindowsGraphicsCapture {
+class WindowsGraphicsCapture : public FrameSource {
 private:
     ID3D11Device* d3d_device = nullptr;
     ID3D11DeviceContext* d3d_context = nullptr;
@@ -37,14 +38,26 @@ private:
     IDXGIFactory1* dxgi_factory = nullptr;
     IDXGIOutput1* dxgi_output1 = nullptr;
     
+    // CPU-readable texture sized to the last requested region
+    ID3D11Texture2D* staging_texture = nullptr;
+    cv::Size staging_size;
+    DXGI_FORMAT staging_format = DXGI_FORMAT_UNKNOWN;
+    
     bool initialized = false;
     cv::Size screen_size;
+    int64_t frame_counter = 0;
 
 public:
     WindowsGraphicsCapture();
-    ~WindowsGraphicsCapture();
+    ~WindowsGraphicsCapture() override;
     
     bool is_initialized() const;
+    bool is_open() const override { return initialized; }
+    cv::Size get_source_size() const override { return screen_size; }
+    // Copies only `region` of the desktop to the CPU, as BGRA
+    bool grab(const cv::Rect& region, Frame& frame) override;
+    
+    // BGR convenience wrappers around grab()
     cv::Mat capture_screen();
     cv::Mat capture_fov(int fov_width = 400, int fov_height = 400);
     cv::Size get_screen_size() const;
@@ -53,7 +66,8 @@ public:
 private:
     bool initialize_d3d();
     void cleanup();
-    cv::Rect calculate_fov_region(int fov_width, int fov_height);
+    bool acquire_desktop_texture(ID3D11Texture2D** desktop_texture);
+    bool ensure_staging_texture(const cv::Size& size, DXGI_FORMAT format);
     bool check_permissions();
     bool reinitialize_capture();
-}; 
\ No newline at end of file
+};
\ No newline at end of file
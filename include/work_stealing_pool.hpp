@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of workers with one task deque each. A worker pops its own deque
+// from the back (keeps caches warm for re-submitted work) and steals from the
+// front of other deques when it runs dry. Tasks receive the worker index so
+// they can use per-worker state without locking. Tasks must not throw.
+class WorkStealingPool {
+public:
+    using Task = std::function<void(int worker_id)>;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex wait_mutex;
+    std::condition_variable work_available;
+    std::condition_variable idle;
+    std::atomic<size_t> pending{0};     // Submitted but not finished
+    std::atomic<size_t> next_queue{0};
+    std::atomic<uint64_t> steals{0};
+    bool stopping = false;
+
+    static thread_local const WorkStealingPool* current_pool;
+    static thread_local int current_worker;
+
+public:
+    explicit WorkStealingPool(int num_workers);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // From a worker the task goes to that worker's deque, otherwise round-robin
+    void submit(Task task);
+    // Blocks until every submitted task (including re-submitted ones) has finished
+    void wait_idle();
+
+    int get_num_workers() const { return static_cast<int>(workers.size()); }
+    uint64_t get_steal_count() const { return steals.load(std::memory_order_relaxed); }
+
+private:
+    void worker_loop(int worker_id);
+    bool pop_local(int worker_id, Task& task);
+    bool steal(int worker_id, Task& task);
+};
@@ -1,32 +1,105 @@
 #pragma once
 
 #include "yolov8_model.hpp"
-#include "yolov8_preprocessor.hpp"
-#include "yolov8_postprocessor.hpp"
+#include "model_slot.hpp"
+#include "detection_workspace.hpp"
+#include "async_detector.hpp"
+#include "cascade_gate.hpp"
+#include "frame_change_detector.hpp"
+#include "tiled_detector.hpp"
 #include "yolov8_visualizer.hpp"
 #include "fov_processor.hpp"
+#include "startup_profile.hpp"
 #include <opencv2/opencv.hpp>
 #include <vector>
+#include <atomic>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <string>
+
+struct ModelSwapStats {
+    uint64_t swaps = 0;
+    uint64_t failures = 0;
+    double last_load_ms = 0.0;         // Session creation + warmup of the last replacement
+    std::string model_path;            // Model currently serving frames
+};
 
 class YOLOv8 {
 private:
-    std::unique_ptr<YOLOv8Model> model;
-    std::unique_ptr<YOLOv8Preprocessor> preprocessor;
-    std::unique_ptr<YOLOv8Postprocessor> postprocessor;
+    ConfigManager config;                            // Copy of the construction config, overrides included
+    std::shared_ptr<ModelSlot> models;
+    std::unique_ptr<DetectionWorkspace> workspace;
     std::unique_ptr<YOLOv8Visualizer> visualizer;
     std::unique_ptr<FOVProcessor> fov_processor;
+    std::unique_ptr<CascadeGate> cascade;            // Optional gate in front of the full model
+    std::unique_ptr<TiledDetector> tiled_detector;   // Optional tiling of large frames
+    std::unique_ptr<FrameChangeDetector> change_detector;  // Optional unchanged-frame early-out
+    DetectionArena results;                          // This frame's results, reused as-is for unchanged frames
+    DetectionTimings last_timings;
+    std::unique_ptr<AsyncDetector> async_detector;   // Created on first detect_async
+    std::once_flag async_init;
+
+    // Hot swap: the replacement is loaded and warmed up off the frame path and
+    // published at the start of the next frame
+    std::mutex swap_mutex;
+    std::future<std::shared_ptr<YOLOv8Model>> pending_model;
+    std::string pending_model_path;
+    std::chrono::steady_clock::time_point pending_since;
+    std::atomic<bool> swap_ready{false};
+    // Free replaced sessions off the frame path; finished ones are pruned on the next swap.
+    // Never reassigned: destroying an unfinished std::async future would block on it
+    std::vector<std::future<void>> retired_releases;
+    ModelSwapStats swap_stats;
+    float conf_threshold = 0.2f;
+    float iou_threshold = 0.2f;
+    Logger logger;
 
 public:
     YOLOv8(const std::string& model_path, float conf_thres = 0.2f, float iou_thres = 0.2f);
-    ~YOLOv8() = default;
+    // Shares an already parsed config; init steps are added to `startup` when given
+    YOLOv8(const std::string& model_path, ConfigManager& config, float conf_thres = 0.2f, float iou_thres = 0.2f,
+           StartupProfile* startup = nullptr);
+    ~YOLOv8();
     
-    std::vector<Detection> detect_objects(const cv::Mat& image);
-    cv::Mat draw_detections(const cv::Mat& image, const std::vector<Detection>& detections);
+    // The returned views stay valid until the next detect_objects / detect_objects_fov call
+    Span<const Detection> detect_objects(const cv::Mat& image);
+    cv::Mat draw_detections(const cv::Mat& image, Span<const Detection> detections);
+    const DetectionTimings& get_last_timings() const;
+    std::string get_arena_stats() { return models->acquire()->get_arena_stats(); }
+    const char* get_backend_name() const { return models->acquire()->get_backend_name(); }
+
+    // Starts loading `model_path` on a background thread, with blood.cfg re-read and the
+    // overrides of the construction config (command line) applied on top; frames keep running on the current model until the replacement is warmed up.
+    // Returns false if a swap is already in progress.
+    bool request_model_swap(const std::string& model_path);
+    bool is_swap_pending();
+    ModelSwapStats get_swap_stats();
+    // nullptr when [Cascade] is disabled
+    const CascadeGate* get_cascade() const { return cascade.get(); }
+    // nullptr when [Capture] enable_frame_skip is off
+    const FrameChangeDetector* get_change_detector() const { return change_detector.get(); }
+    // nullptr when [Tiling] is disabled
+    const TiledDetector* get_tiled_detector() const { return tiled_detector.get(); }
+
+    // Asynchronous detection ([Async] config); callbacks run on worker threads
+    std::future<DetectionResult> detect_async(const cv::Mat& image);
+    void detect_async(const cv::Mat& image, AsyncDetector::Callback callback);
     
     // FOV specific methods
     void set_fov_size(int width, int height);
     cv::Size get_fov_size() const;
-    std::vector<Detection> detect_objects_fov(const cv::Mat& fov_image);
-    cv::Mat draw_fov_detections(const cv::Mat& fov_image, const std::vector<Detection>& detections);
+    // Detections plus their FOV metrics, computed in one pass over the frame's results
+    FrameDetections detect_objects_fov(const cv::Mat& fov_image);
+    cv::Mat draw_fov_detections(const cv::Mat& fov_image, const FrameDetections& detections);
+
+private:
+    void initialize(const std::string& model_path, float conf_thres, float iou_thres, StartupProfile* startup);
+    // Cascade (if enabled) and full model, without the unchanged-frame early-out
+    void run_detection(const cv::Mat& image, std::vector<Detection>& detections);
+    // Full model, tiled when enabled and the frame is larger than a tile
+    void run_full_model(const cv::Mat& image, std::vector<Detection>& detections);
+    AsyncDetector& get_async_detector();
+    // Publishes a finished replacement; called between frames
+    void apply_pending_swap();
 }; 
\ No newline at end of file
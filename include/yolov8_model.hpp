@@ -1,36 +1,58 @@
 #pragma once
 
 #include "config_manager.hpp"
+#include "inference_backend.hpp"
 #include "logger.hpp"
 #include <opencv2/opencv.hpp>
-#include <onnxruntime_cxx_api.h>
+#include <memory>
 #include <vector>
 #include <string>
 
 class YOLOv8Model {
 private:
-    Ort::Session session{nullptr};
-    Ort::Env env;
-    std::vector<std::string> input_names;
-    std::vector<std::string> output_names;
+    std::unique_ptr<InferenceBackend> backend;
+    std::string backend_kind = "onnxruntime";
     int input_height = 640;
     int input_width = 640;
     float conf_threshold = 0.2f;
     float iou_threshold = 0.2f;
-    ConfigManager config;
+    int intra_op_threads = 0;
+    SessionMemoryOptions memory_options;
+    uint64_t instance_id = 0;
     Logger logger;
 
 public:
-    YOLOv8Model(const std::string& model_path, float conf_thres = 0.2f, float iou_thres = 0.2f);
+    // intra_threads <= 0 keeps the default of 8 intra-op threads
+    YOLOv8Model(const std::string& model_path, float conf_thres = 0.2f, float iou_thres = 0.2f, int intra_threads = 0);
+    // Same, with [Model] settings taken from an already parsed config
+    YOLOv8Model(const std::string& model_path, ConfigManager& config, float conf_thres = 0.2f, float iou_thres = 0.2f, int intra_threads = 0);
     ~YOLOv8Model() = default;
     
-    std::vector<Ort::Value> run_inference(const std::vector<float>& input_tensor);
+    // Safe to call concurrently (the backend serializes runs if its engine needs it).
+    // The returned views stay valid as long as the InferenceOutput is alive.
+    InferenceOutput run_inference(const std::vector<float>& input_tensor);
+    // For uint8 models: continuous input-sized BGR image, fed without conversion
+    InferenceOutput run_inference(const cv::Mat& input_image);
+    bool has_uint8_input() const { return backend->input_type() == TensorElementType::UInt8; }
     int get_input_width() const { return input_width; }
     int get_input_height() const { return input_height; }
     float get_conf_threshold() const { return conf_threshold; }
     float get_iou_threshold() const { return iou_threshold; }
+    // Unique per loaded model, so per-thread state can tell a swapped-in model apart
+    uint64_t get_instance_id() const { return instance_id; }
+    // "onnxruntime" or "opencv" ([Model] backend)
+    const char* get_backend_name() const { return backend->name(); }
+    // Runs `iterations` inferences on a blank input so the first real frame doesn't pay for
+    // kernel selection and arena growth; returns the time spent in ms
+    double warmup(int iterations);
+    // [Performance] enable_model_warmup / warmup_iterations, 0 when warmup is disabled
+    static int warmup_iterations_from_config(ConfigManager& config);
+    // [Memory] share_weights, layout_optimization, shared_arena, arena_extend_strategy, arena_max_mb, arena_initial_chunk_kb
+    static SessionMemoryOptions memory_options_from_config(ConfigManager& config);
+    // Backend allocator statistics ("InUse=... MaxInUse=..."), empty when the backend cannot report them
+    std::string get_arena_stats() { return backend->get_arena_stats(); }
 
 private:
-    void load_config_from_file();
+    void load_config_from_file(ConfigManager& config);
     void initialize_model(const std::string& model_path);
-}; 
\ No newline at end of file
+};
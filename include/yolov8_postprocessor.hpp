@@ -1,21 +1,12 @@
 #pragma once
 
+#include "detection.hpp"
+#include "inference_backend.hpp"
 #include "logger.hpp"
+#include "yolov8_preprocessor.hpp"
 #include <opencv2/opencv.hpp>
-#include <onnxruntime_cxx_api.h>
 #include <vector>
 
-struct Detection {
-    cv::Rect box;
-    float score;
-    int class_id;
-    
-    // FOV relative coordinates
-    cv::Point2f fov_center;  // Center point relative to FOV (0-1)
-    float fov_distance;      // Distance from FOV center (0-1)
-    float fov_angle;         // Angle from FOV center in radians
-};
-
 class YOLOv8Postprocessor {
 private:
     float conf_threshold = 0.2f;
@@ -24,15 +15,35 @@ private:
     int input_height = 640;
     Logger logger;
 
+    // Scratch reused across frames by the dispatched kernels
+    std::vector<float> best_scores;
+    std::vector<int> best_classes;
+    std::vector<int> candidates;
+    std::vector<int> nms_order;
+    std::vector<Detection> nms_sorted;
+    std::vector<float> nms_x1, nms_y1, nms_x2, nms_y2, nms_area;
+    std::vector<int> nms_class;
+    std::vector<uint8_t> suppressed;
+
 public:
     YOLOv8Postprocessor(float conf_thres = 0.2f, float iou_thres = 0.2f, int width = 640, int height = 640);
     ~YOLOv8Postprocessor() = default;
     
-    std::vector<Detection> process_output(const std::vector<Ort::Value>& outputs, const cv::Size& original_size);
-    std::vector<Detection> non_max_suppression(const std::vector<Detection>& detections);
+    // Decodes and suppresses straight into `detections` (cleared first, capacity kept)
+    void process_output(const InferenceOutput& outputs, const cv::Size& original_size,
+                        const LetterboxInfo& letterbox, std::vector<Detection>& detections);
+    // In place: survivors are compacted to the front in score order
+    void non_max_suppression(std::vector<Detection>& detections);
+    // Suppression only between boxes of the same class (merging tiles, multi-class models)
+    void class_aware_nms(std::vector<Detection>& detections, float iou_thres);
     void set_thresholds(float conf_thres, float iou_thres);
     void set_input_size(int width, int height);
 
 private:
-    float calculate_iou(const cv::Rect& box1, const cv::Rect& box2);
+    void decode_nms_output(const float* output_data, int num_dets, const cv::Size& original_size,
+                           const LetterboxInfo& letterbox, std::vector<Detection>& detections);
+    // Center/size box in model input pixels -> clamped box in the original image
+    Detection make_detection(float x, float y, float w, float h, float score, int class_id,
+                             const cv::Size& original_size, const LetterboxInfo& letterbox) const;
+    void suppress(std::vector<Detection>& detections, float iou_thres, bool class_aware);
 }; 
\ No newline at end of file
@@ -3,19 +3,71 @@
 #include "logger.hpp"
 #include <opencv2/opencv.hpp>
 #include <vector>
+#include <string>
+
+// How the source image is fitted into the model input
+enum class ResizeMode {
+    Stretch,    // Independent x/y scale (distorts non-square inputs)
+    Letterbox   // Uniform scale, remaining area filled with pad_value
+};
+
+// Mapping from source image coordinates to model input coordinates:
+// input = source * scale + pad
+struct LetterboxInfo {
+    float scale_x = 1.0f;
+    float scale_y = 1.0f;
+    int pad_x = 0;
+    int pad_y = 0;
+};
 
 class YOLOv8Preprocessor {
 private:
     int input_width = 640;
     int input_height = 640;
+    ResizeMode resize_mode = ResizeMode::Stretch;
+    int pad_value = 114;
     Logger logger;
 
+    // Bilinear remap tables, valid for one (source size, channels, target size)
+    struct RemapTables {
+        cv::Size source_size;
+        int source_channels = 0;
+        cv::Rect content;                  // Area of the input covered by the image
+        LetterboxInfo letterbox;
+        std::vector<int> x0_offsets;       // Byte offsets of left/right taps per content column
+        std::vector<int> x1_offsets;
+        std::vector<float> x_weights;      // Weight of the right tap
+        std::vector<int> y0_rows;          // Source rows of top/bottom taps per content row
+        std::vector<int> y1_rows;
+        std::vector<float> y_weights;      // Weight of the bottom tap
+        int generation = 0;                // Bumped on every rebuild
+    };
+    RemapTables tables;
+    std::vector<float> input_tensor;
+    int input_tensor_generation = -1;
+    cv::Mat input_image;                   // uint8 HWC buffer for uint8 models
+    int input_image_generation = -1;
+
 public:
-    YOLOv8Preprocessor(int width = 640, int height = 640);
+    YOLOv8Preprocessor(int width = 640, int height = 640, ResizeMode mode = ResizeMode::Stretch);
     ~YOLOv8Preprocessor() = default;
-    
-    std::vector<float> prepare_input(const cv::Mat& image);
+
+    // Accepts 8-bit BGR or BGRA frames
+    const std::vector<float>& prepare_input(const cv::Mat& image);
+    // uint8 BGR HWC model input; returns a BGR frame itself when no resize is needed
+    const cv::Mat& prepare_input_u8(const cv::Mat& image);
     void set_input_size(int width, int height);
+    void set_resize_mode(ResizeMode mode, int pad = 114);
     int get_input_width() const { return input_width; }
     int get_input_height() const { return input_height; }
-}; 
\ No newline at end of file
+    ResizeMode get_resize_mode() const { return resize_mode; }
+    // Letterbox parameters used by the last prepare_input call
+    const LetterboxInfo& get_letterbox_info() const { return tables.letterbox; }
+
+    static ResizeMode parse_resize_mode(const std::string& value);
+
+private:
+    bool update_remap_tables(const cv::Mat& image);
+    void build_remap_tables(const cv::Size& source_size, int channels);
+    void invalidate_tables();
+};
@@ -3,12 +3,25 @@
 #include "config_manager.hpp"
 #include "yolov8_postprocessor.hpp"
 #include <opencv2/opencv.hpp>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <random>
 
+// [Display] settings, resolved once at construction
+struct RenderStyle {
+    bool use_box_color = true;         // false: per-class random colors
+    cv::Scalar box_color = cv::Scalar(0, 0, 255);
+    cv::Scalar text_color = cv::Scalar(255, 255, 255);
+    int box_thickness = 2;
+    float text_scale = 0.5f;
+    bool show_confidence = true;
+    bool show_class_name = true;
+};
+
 class YOLOv8Visualizer {
 private:
-    ConfigManager config;
+    RenderStyle style;
     std::vector<cv::Scalar> colors;
     std::vector<std::string> class_names = {
         "player",      // Jogadores aliados
@@ -19,13 +32,29 @@ private:
         "blood"        // Sangue/efeitos visuais
     };
 
+    // Label text and its size per (class, integer percent)
+    struct CachedLabel {
+        std::string text;
+        cv::Size size;
+    };
+    std::unordered_map<int64_t, CachedLabel> label_cache;
+
 public:
     YOLOv8Visualizer(const std::string& config_file = "blood.cfg");
+    explicit YOLOv8Visualizer(ConfigManager& config);
     ~YOLOv8Visualizer() = default;
     
-    cv::Mat draw_detections(const cv::Mat& image, const std::vector<Detection>& detections);
-    cv::Mat draw_fov_detections(const cv::Mat& fov_image, const std::vector<Detection>& detections, int fov_width, int fov_height);
+    cv::Mat draw_detections(const cv::Mat& image, Span<const Detection> detections);
+    cv::Mat draw_fov_detections(const cv::Mat& fov_image, const FrameDetections& detections, int fov_width, int fov_height);
+
+    // Draw straight into a frame buffer owned by the caller, no copies
+    void draw_detections_in_place(cv::Mat& image, Span<const Detection> detections);
+    // FOV metric labels are drawn when detections.fov is filled
+    void draw_fov_detections_in_place(cv::Mat& image, const FrameDetections& detections, int fov_width, int fov_height);
+    const RenderStyle& get_style() const { return style; }
 
 private:
     void initialize_colors();
-}; 
\ No newline at end of file
+    void load_style(ConfigManager& config);
+    const CachedLabel& get_label(const Detection& det);
+};
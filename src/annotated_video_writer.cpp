@@ -0,0 +1,175 @@
+#include "annotated_video_writer.hpp"
+#include "metrics.hpp"
+#include "memory_tracker.hpp"
+#include <algorithm>
+
+AnnotatedVideoWriter::AnnotatedVideoWriter(const OutputOptions& output_options, const std::string& config_file)
+    : options(output_options), visualizer(config_file) {
+    options.queue_size = std::max<size_t>(1, options.queue_size);
+    raw_output = RawFrameSource::is_raw_file(options.path);
+    writer_thread = std::thread(&AnnotatedVideoWriter::writer_loop, this);
+    logger.info("[AnnotatedVideoWriter][INFO] Writing to " + options.path + " (queue " + std::to_string(options.queue_size) + ")");
+}
+
+AnnotatedVideoWriter::~AnnotatedVideoWriter() {
+    close();
+}
+
+OutputOptions AnnotatedVideoWriter::options_from_config(ConfigManager& config) {
+    auto result = OutputOptions();
+    result.enabled = config.get_string("Output", "enabled", "false") == "true";
+    result.path = config.get_string("Output", "path", result.path);
+    result.fourcc = config.get_string("Output", "fourcc", result.fourcc);
+    result.fps = config.get_float("Output", "fps", static_cast<float>(result.fps));
+    result.queue_size = static_cast<size_t>(std::max(1, config.get_int("Output", "queue_size", static_cast<int>(result.queue_size))));
+    result.policy = parse_policy(config.get_string("Output", "backpressure", "drop"));
+    result.render = config.get_string("Output", "render", "true") == "true";
+    return result;
+}
+
+BackpressurePolicy AnnotatedVideoWriter::parse_policy(const std::string& value) {
+    if (value == "block") return BackpressurePolicy::Block;
+    if (value == "downsample") return BackpressurePolicy::Downsample;
+    return BackpressurePolicy::Drop;
+}
+
+bool AnnotatedVideoWriter::submit(const cv::Mat& image, Span<const Detection> detections, int64_t timestamp_us) {
+    auto scope = StageScope(PipelineStage::Output);
+    if (image.empty()) {
+        return false;
+    }
+    auto frame = std::unique_ptr<QueuedFrame>();
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        if (stopping) {
+            return false;
+        }
+        ++stats.submitted;
+
+        // Backpressure decided before any copy, so a dropped frame costs nothing
+        if (options.policy == BackpressurePolicy::Block) {
+            queue_not_full.wait(lock, [this] { return queue.size() < options.queue_size || stopping; });
+        } else if (queue.size() >= options.queue_size) {
+            ++stats.dropped;
+            detection_metrics().output_dropped.add();
+            return false;
+        } else if (options.policy == BackpressurePolicy::Downsample && queue.size() >= options.queue_size / 2) {
+            downsample_toggle = !downsample_toggle;
+            if (downsample_toggle) {
+                ++stats.downsampled;
+                return false;
+            }
+        }
+        if (!free_frames.empty()) {
+            frame = std::move(free_frames.back());
+            free_frames.pop_back();
+        }
+    }
+
+    if (!frame) {
+        frame = std::make_unique<QueuedFrame>();
+    }
+    image.copyTo(frame->image);
+    frame->format = image.channels() == 4 ? PixelFormat::BGRA : PixelFormat::BGR;
+    frame->detections.assign(detections.begin(), detections.end());
+    frame->timestamp_us = timestamp_us;
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        queue.push_back(std::move(frame));
+        stats.max_queue_depth = std::max(stats.max_queue_depth, queue.size());
+        detection_metrics().output_queue_depth.set(static_cast<int64_t>(queue.size()));
+    }
+    queue_not_empty.notify_one();
+    return true;
+}
+
+void AnnotatedVideoWriter::close() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (stopping) {
+            return;
+        }
+        stopping = true;
+    }
+    queue_not_empty.notify_all();
+    queue_not_full.notify_all();
+    if (writer_thread.joinable()) {
+        writer_thread.join();
+    }
+    video_writer.release();
+    raw_recorder.close();
+    auto final_stats = get_stats();
+    logger.info("[AnnotatedVideoWriter][INFO] Closed " + options.path + ": " + std::to_string(final_stats.written) + " written, " +
+                std::to_string(final_stats.dropped) + " dropped, " + std::to_string(final_stats.downsampled) + " downsampled");
+}
+
+OutputStats AnnotatedVideoWriter::get_stats() {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    return stats;
+}
+
+void AnnotatedVideoWriter::writer_loop() {
+    while (true) {
+        auto frame = std::unique_ptr<QueuedFrame>();
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_not_empty.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            frame = std::move(queue.front());
+            queue.pop_front();
+            detection_metrics().output_queue_depth.set(static_cast<int64_t>(queue.size()));
+        }
+        queue_not_full.notify_one();
+
+        write_frame(*frame);
+
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        free_frames.push_back(std::move(frame));
+    }
+}
+
+void AnnotatedVideoWriter::write_frame(QueuedFrame& frame) {
+    auto scope = StageScope(PipelineStage::Output);
+    if (output_failed) {
+        return;
+    }
+    if (options.render) {
+        visualizer.draw_detections_in_place(frame.image, frame.detections);
+    }
+
+    // 1. Raw container: frames are stored as they come
+    if (raw_output) {
+        if (!raw_recorder.is_open() && !raw_recorder.open(options.path)) {
+            output_failed = true;
+            return;
+        }
+        auto raw_frame = Frame();
+        raw_frame.image = frame.image;
+        raw_frame.format = frame.format;
+        raw_frame.timestamp_us = frame.timestamp_us;
+        raw_recorder.write(raw_frame);
+    } else {
+        // 2. Encoded video: opened on the first frame, needs 3-channel BGR
+        const auto& bgr = frame.format == PixelFormat::BGRA ? bgr_scratch : frame.image;
+        if (frame.format == PixelFormat::BGRA) {
+            cv::cvtColor(frame.image, bgr_scratch, cv::COLOR_BGRA2BGR);
+        }
+        if (!video_writer.isOpened()) {
+            auto code = options.fourcc.size() == 4
+                ? cv::VideoWriter::fourcc(options.fourcc[0], options.fourcc[1], options.fourcc[2], options.fourcc[3])
+                : cv::VideoWriter::fourcc('m', 'p', '4', 'v');
+            if (!video_writer.open(options.path, code, options.fps, bgr.size(), true)) {
+                logger.error("[AnnotatedVideoWriter][ERROR] Could not open video output: " + options.path);
+                output_failed = true;
+                return;
+            }
+        }
+        video_writer.write(bgr);
+    }
+
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    ++stats.written;
+}
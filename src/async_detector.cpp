@@ -0,0 +1,194 @@
+#include "async_detector.hpp"
+#include "metrics.hpp"
+#include <algorithm>
+
+AsyncDetector::AsyncDetector(std::shared_ptr<ModelSlot> shared_models, ConfigManager& config,
+                             const AsyncDetectorOptions& detector_options)
+    : models(std::move(shared_models)), options(detector_options) {
+    auto model = models->acquire();
+    options.num_workers = std::max(1, options.num_workers);
+    options.max_in_flight = std::max<size_t>(1, options.max_in_flight);
+    for (int i = 0; i < options.num_workers; ++i) {
+        workspaces.push_back(std::make_unique<DetectionWorkspace>(*model, config));
+    }
+    for (int i = 0; i < options.num_workers; ++i) {
+        workers.emplace_back(&AsyncDetector::worker_loop, this, i);
+    }
+}
+
+AsyncDetector::~AsyncDetector() {
+    // Pending requests are still processed before the workers exit
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_not_empty.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+AsyncDetectorOptions AsyncDetector::options_from_config(ConfigManager& config) {
+    auto result = AsyncDetectorOptions();
+    result.num_workers = config.get_int("Async", "num_workers", result.num_workers);
+    result.max_in_flight = static_cast<size_t>(std::max(1, config.get_int("Async", "max_in_flight",
+                                                                           static_cast<int>(result.max_in_flight))));
+    result.ordered_callbacks = config.get_string("Async", "ordered_callbacks", "true") == "true";
+    result.copy_frames = config.get_string("Async", "copy_frames", "true") == "true";
+    return result;
+}
+
+std::future<DetectionResult> AsyncDetector::submit(const cv::Mat& frame) {
+    auto request = std::make_unique<Request>();
+    request->frame = options.copy_frames ? frame.clone() : frame;
+    request->has_promise = true;
+    auto future = request->promise.get_future();
+    enqueue(std::move(request));
+    return future;
+}
+
+void AsyncDetector::submit(const cv::Mat& frame, Callback callback) {
+    auto request = std::make_unique<Request>();
+    request->frame = options.copy_frames ? frame.clone() : frame;
+    request->callback = std::move(callback);
+    enqueue(std::move(request));
+}
+
+size_t AsyncDetector::get_in_flight() {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    return in_flight;
+}
+
+void AsyncDetector::enqueue(std::unique_ptr<Request> request) {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    // Bounded in-flight: backpressure on the caller instead of an unbounded queue
+    slot_available.wait(lock, [this] { return in_flight < options.max_in_flight || stopping; });
+    if (stopping) {
+        lock.unlock();
+        // Not dropped silently: the caller gets a failed result
+        auto result = DetectionResult();
+        result.error = "AsyncDetector is stopping";
+        if (request->has_promise) {
+            request->promise.set_exception(std::make_exception_ptr(std::runtime_error(result.error)));
+        } else {
+            invoke(request->callback, result);
+        }
+        return;
+    }
+    ++in_flight;
+    detection_metrics().frames_in.add();
+    detection_metrics().async_in_flight.add(1);
+    request->sequence = next_sequence++;
+    request->submitted = std::chrono::steady_clock::now();
+    if (!request->has_promise && options.ordered_callbacks) {
+        request->delivery_sequence = next_callback_sequence++;
+    }
+    queue.push_back(std::move(request));
+    lock.unlock();
+    queue_not_empty.notify_one();
+}
+
+void AsyncDetector::release_slot() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        --in_flight;
+    }
+    detection_metrics().async_in_flight.add(-1);
+    slot_available.notify_one();
+}
+
+void AsyncDetector::worker_loop(int worker_id) {
+    auto& workspace = *workspaces[worker_id];
+    while (true) {
+        auto request = std::unique_ptr<Request>();
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_not_empty.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            request = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        auto result = DetectionResult();
+        result.sequence = request->sequence;
+        try {
+            auto model = models->acquire();
+            workspace.detect(*model, request->frame, result.detections);
+            result.timings = workspace.get_last_timings();
+        } catch (const std::exception& e) {
+            result.error = e.what();
+            logger.error("[AsyncDetector][ERROR] Detection failed: " + result.error);
+        }
+        result.latency_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - request->submitted).count();
+        detection_metrics().detect_latency.observe_ms(result.latency_ms);
+        detection_metrics().frames_out.add();
+        complete(std::move(request), result);
+    }
+}
+
+void AsyncDetector::invoke(Callback& callback, DetectionResult& result) {
+    // A throwing callback must not take the worker thread down
+    try {
+        callback(result);
+    } catch (const std::exception& e) {
+        logger.error("[AsyncDetector][ERROR] Callback threw: " + std::string(e.what()));
+    } catch (...) {
+        logger.error("[AsyncDetector][ERROR] Callback threw an unknown exception");
+    }
+}
+
+void AsyncDetector::complete(std::unique_ptr<Request> request, DetectionResult& result) {
+    request->frame.release();
+    // The slot is free before any callback runs, so a callback may submit again
+    // even at the in-flight limit
+    release_slot();
+
+    // Futures: fulfilled immediately, the caller decides the order it waits in
+    if (request->has_promise) {
+        if (result.error.empty()) {
+            request->promise.set_value(std::move(result));
+        } else {
+            request->promise.set_exception(std::make_exception_ptr(std::runtime_error(result.error)));
+        }
+        return;
+    }
+
+    // Unordered callbacks: delivered from the worker as soon as they finish
+    if (!options.ordered_callbacks) {
+        invoke(request->callback, result);
+        return;
+    }
+
+    // Ordered callbacks: park in the reorder buffer. The worker that finds no delivery in
+    // progress becomes the deliverer: it takes the contiguous prefix under the lock and runs
+    // it unlocked, until nothing is ready. Other workers only park, so order is preserved.
+    auto ready = std::vector<std::pair<Callback, DetectionResult>>();
+    {
+        std::lock_guard<std::mutex> lock(delivery_mutex);
+        completed.emplace(request->delivery_sequence, std::make_pair(std::move(request->callback), std::move(result)));
+        if (delivering) {
+            return;
+        }
+        delivering = true;
+    }
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(delivery_mutex);
+            ready.clear();
+            for (auto it = completed.find(next_delivery); it != completed.end(); it = completed.find(next_delivery)) {
+                ready.push_back(std::move(it->second));
+                completed.erase(it);
+                ++next_delivery;
+            }
+            if (ready.empty()) {
+                delivering = false;
+                return;
+            }
+        }
+        for (auto& entry : ready) {
+            invoke(entry.first, entry.second);
+        }
+    }
+}
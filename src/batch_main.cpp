@@ -0,0 +1,520 @@
+#include "logger.hpp"
+#include "config_manager.hpp"
+#include "yolov8_detector.hpp"
+#include "file_frame_source.hpp"
+#include "child_process.hpp"
+#include "cpu_dispatch.hpp"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+struct BatchOptions {
+    std::string manifest;
+    std::string output_dir;
+    std::string model_path;
+    std::string backend;
+    cv::Size region;
+    int workers = 0;
+    int cores_per_worker = 0;
+    int checkpoint_frames = 0;
+    int retries = -1;
+    // Worker mode (spawned by the coordinator)
+    bool worker = false;
+    int64_t job = -1;
+    std::string cores;
+};
+
+// Progress of one manifest entry. `bytes` is the size of the part file at `frame`:
+// anything written after it is dropped on resume. The input path, size and modification
+// time tie it to one file: parts are named by manifest line, and the manifest may change.
+struct Checkpoint {
+    std::string input;
+    int64_t input_size = 0;
+    int64_t input_mtime = 0;
+    int64_t frame = 0;
+    int64_t bytes = 0;
+    int64_t detections = 0;
+    bool done = false;
+};
+
+void print_usage() {
+    std::cout << "Usage: dogai_batch <manifest> --output <dir> [options]\n"
+              << "  <manifest>           text file, one input per line (.raw, video, image directory); # comments\n"
+              << "  --output <dir>       checkpoints, per-file parts and the merged detections.csv\n"
+              << "  --model <path>       ONNX model (default: [Model] model_path)\n"
+              << "  --backend <name>     inference backend: onnxruntime, opencv (default: [Model] backend)\n"
+              << "  --workers <n>        worker processes (default: [Batch] workers)\n"
+              << "  --cores <n>          cores pinned to each worker (default: [Batch] cores_per_worker)\n"
+              << "  --checkpoint <n>     frames between checkpoints (default: [Batch] checkpoint_frames)\n"
+              << "  --retries <n>        restarts of a failed file, resuming from its checkpoint (default: [Batch] retries)\n"
+              << "  --region <w>x<h>     centered region to grab (default: full frame)\n"
+              << "Rerunning with the same manifest and --output resumes an interrupted job.\n";
+}
+
+bool parse_options(int argc, char** argv, BatchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        auto arg = std::string(argv[i]);
+        auto has_value = i + 1 < argc;
+        if (arg == "--output" && has_value) {
+            options.output_dir = argv[++i];
+        } else if (arg == "--model" && has_value) {
+            options.model_path = argv[++i];
+        } else if (arg == "--backend" && has_value) {
+            options.backend = argv[++i];
+        } else if (arg == "--workers" && has_value) {
+            options.workers = std::stoi(argv[++i]);
+        } else if (arg == "--cores" && has_value) {
+            options.cores_per_worker = std::stoi(argv[++i]);
+        } else if (arg == "--checkpoint" && has_value) {
+            options.checkpoint_frames = std::stoi(argv[++i]);
+        } else if (arg == "--retries" && has_value) {
+            options.retries = std::stoi(argv[++i]);
+        } else if (arg == "--region" && has_value) {
+            auto value = std::string(argv[++i]);
+            auto x = value.find('x');
+            if (x == std::string::npos) return false;
+            options.region = cv::Size(std::stoi(value.substr(0, x)), std::stoi(value.substr(x + 1)));
+        } else if (arg == "--worker") {
+            options.worker = true;
+        } else if (arg == "--job" && has_value) {
+            options.job = std::stoll(argv[++i]);
+        } else if (arg == "--pin" && has_value) {
+            options.cores = argv[++i];
+        } else if (options.manifest.empty() && !arg.empty() && arg[0] != '-') {
+            options.manifest = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options.manifest.empty() && !options.output_dir.empty() && (!options.worker || options.job >= 0);
+}
+
+std::vector<std::string> read_manifest(const std::string& path) {
+    auto inputs = std::vector<std::string>();
+    auto file = std::ifstream(path);
+    auto line = std::string();
+    while (std::getline(file, line)) {
+        auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+        auto last = line.find_last_not_of(" \t\r");
+        inputs.push_back(line.substr(first, last - first + 1));
+    }
+    return inputs;
+}
+
+std::string part_path(const std::string& output_dir, int64_t job) {
+    return (std::filesystem::path(output_dir) / "parts" / (std::to_string(job) + ".csv")).string();
+}
+
+std::string checkpoint_path(const std::string& output_dir, int64_t job) {
+    return (std::filesystem::path(output_dir) / "parts" / (std::to_string(job) + ".ckpt")).string();
+}
+
+// Fresh checkpoint for `input` (directories: size 0, their own modification time)
+Checkpoint new_checkpoint(const std::string& input) {
+    auto checkpoint = Checkpoint();
+    auto error = std::error_code();
+    checkpoint.input = input;
+    auto size = std::filesystem::is_regular_file(input, error) ? std::filesystem::file_size(input, error) : 0;
+    checkpoint.input_size = error ? 0 : static_cast<int64_t>(size);
+    checkpoint.input_mtime = static_cast<int64_t>(std::filesystem::last_write_time(input, error).time_since_epoch().count());
+    return checkpoint;
+}
+
+// False (and a fresh checkpoint) when there is none or it belongs to another version of the
+// line: a different path after a manifest edit, or a rewritten file. The caller starts over.
+bool load_checkpoint(const std::string& path, const std::string& input, Checkpoint& checkpoint) {
+    checkpoint = new_checkpoint(input);
+    auto file = std::ifstream(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    auto loaded = Checkpoint();
+    auto line = std::string();
+    try {
+        while (std::getline(file, line)) {
+            auto space = line.find(' ');
+            if (space == std::string::npos) continue;
+            auto key = line.substr(0, space);
+            auto value = line.substr(space + 1);
+            if (key == "input") loaded.input = value;
+            else if (key == "input_size") loaded.input_size = std::stoll(value);
+            else if (key == "input_mtime") loaded.input_mtime = std::stoll(value);
+            else if (key == "frame") loaded.frame = std::stoll(value);
+            else if (key == "bytes") loaded.bytes = std::stoll(value);
+            else if (key == "detections") loaded.detections = std::stoll(value);
+            else if (key == "done") loaded.done = value != "0";
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (loaded.input != checkpoint.input || loaded.input_size != checkpoint.input_size ||
+        loaded.input_mtime != checkpoint.input_mtime) {
+        return false;
+    }
+    checkpoint = loaded;
+    return true;
+}
+
+// Written to a temporary file and renamed over the old one, so a kill never leaves a torn checkpoint
+bool save_checkpoint(const std::string& path, const Checkpoint& checkpoint) {
+    auto temporary = path + ".tmp";
+    {
+        auto file = std::ofstream(temporary, std::ios::trunc);
+        file << "input " << checkpoint.input << "\n"
+             << "input_size " << checkpoint.input_size << "\n"
+             << "input_mtime " << checkpoint.input_mtime << "\n"
+             << "frame " << checkpoint.frame << "\n"
+             << "bytes " << checkpoint.bytes << "\n"
+             << "detections " << checkpoint.detections << "\n"
+             << "done " << (checkpoint.done ? 1 : 0) << "\n";
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    auto error = std::error_code();
+    std::filesystem::rename(temporary, path, error);
+    return !error;
+}
+
+// "0-7" or "0,2,4-6"
+std::vector<int> parse_cores(const std::string& value) {
+    auto cores = std::vector<int>();
+    auto stream = std::istringstream(value);
+    auto item = std::string();
+    while (std::getline(stream, item, ',')) {
+        auto dash = item.find('-');
+        auto first = std::stoi(item.substr(0, dash));
+        auto last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+        for (auto core = first; core <= last; ++core) {
+            cores.push_back(core);
+        }
+    }
+    return cores;
+}
+
+std::string csv_quote(const std::string& value) {
+    auto quoted = std::string("\"");
+    for (auto c : value) {
+        if (c == '"') quoted.push_back('"');
+        quoted.push_back(c);
+    }
+    quoted.push_back('"');
+    return quoted;
+}
+
+// Processes one manifest entry from its checkpoint to the end
+int run_worker(const BatchOptions& options, const std::vector<std::string>& inputs) {
+    if (options.job >= static_cast<int64_t>(inputs.size())) {
+        logger.error("[BATCH][ERROR] Job " + std::to_string(options.job) + " is not in the manifest");
+        return 1;
+    }
+    const auto& input = inputs[options.job];
+    auto tag = "Job " + std::to_string(options.job) + ":";
+
+    // 1. Pin before any thread exists, so the backend's threads stay in the core group
+    auto cores = options.cores.empty() ? std::vector<int>() : parse_cores(options.cores);
+    if (!cores.empty() && !pin_current_process(cores)) {
+        logger.warning("[BATCH][WARNING] " + tag + " Could not pin to cores " + options.cores);
+    }
+    // An orphaned worker would keep appending to a part that a rerun is resuming
+    if (!exit_with_parent()) {
+        logger.warning("[BATCH][WARNING] " + tag + " Cannot follow the coordinator's exit on this platform");
+    }
+
+    auto config = ConfigManager("blood.cfg");
+    CpuDispatch::configure(config);
+    if (!options.backend.empty()) config.set_string("Model", "backend", options.backend);
+    if (!cores.empty()) config.set_string("Model", "intra_op_threads", std::to_string(cores.size()));
+    auto model_path = options.model_path.empty() ? config.get_string("Model", "model_path", "models/blood.onnx") : options.model_path;
+    auto checkpoint_frames = std::max(1, options.checkpoint_frames);
+
+    auto checkpoint = Checkpoint();
+    auto checkpoint_file = checkpoint_path(options.output_dir, options.job);
+    if (!load_checkpoint(checkpoint_file, input, checkpoint) && std::filesystem::exists(checkpoint_file)) {
+        logger.warning("[BATCH][WARNING] " + tag + " Checkpoint belongs to another input or version, starting over");
+    }
+    if (checkpoint.done) {
+        return 0;
+    }
+
+    // 2. Resume: position the source at the checkpointed frame (decode and drop when it cannot seek)
+    auto source = open_file_frame_source(input);
+    if (!source->is_open()) {
+        logger.error("[BATCH][ERROR] " + tag + " Could not open input: " + input);
+        return 1;
+    }
+    auto frame = Frame();
+    if (checkpoint.frame > 0 && !source->seek(checkpoint.frame)) {
+        for (int64_t skipped = 0; skipped < checkpoint.frame; ++skipped) {
+            if (!source->grab(cv::Rect(), frame)) {
+                logger.error("[BATCH][ERROR] " + tag + " Input ended before checkpoint frame " + std::to_string(checkpoint.frame));
+                return 1;
+            }
+        }
+    }
+    auto region = options.region.empty() ? cv::Rect() : source->centered_region(options.region.width, options.region.height);
+
+    // Rows after the checkpoint belong to frames that will be processed again (all of them
+    // when the checkpoint was stale: bytes is 0)
+    auto part_file = part_path(options.output_dir, options.job);
+    auto error = std::error_code();
+    if (std::filesystem::exists(part_file, error)) {
+        std::filesystem::resize_file(part_file, static_cast<uintmax_t>(checkpoint.bytes), error);
+    }
+    auto part = std::ofstream(part_file, std::ios::binary | std::ios::app);
+    if (error || !part) {
+        logger.error("[BATCH][ERROR] " + tag + " Could not prepare " + part_file);
+        return 1;
+    }
+    auto written = checkpoint.bytes;
+    char row[192];
+
+    auto detector = YOLOv8(model_path, config);
+    logger.info("[BATCH][INFO] " + tag + " " + input + " from frame " + std::to_string(checkpoint.frame) +
+                (cores.empty() ? std::string() : " on cores " + options.cores));
+
+    // 3. Detect, appending "frame,timestamp_us,class_id,score,x1,y1,x2,y2" rows
+    auto start = std::chrono::steady_clock::now();
+    auto frames = int64_t(0);
+    while (source->grab(region, frame)) {
+        auto detections = detector.detect_objects(frame.image);
+        for (const auto& det : detections) {
+            auto length = std::snprintf(row, sizeof(row), "%lld,%lld,%d,%.4f,%.2f,%.2f,%.2f,%.2f\n",
+                                        static_cast<long long>(checkpoint.frame), static_cast<long long>(frame.timestamp_us),
+                                        det.class_id, det.score, det.x1, det.y1, det.x2, det.y2);
+            part.write(row, length);
+            written += length;
+        }
+        checkpoint.detections += static_cast<int64_t>(detections.size());
+        ++checkpoint.frame;
+        ++frames;
+
+        if (checkpoint.frame % checkpoint_frames == 0) {
+            part.flush();
+            checkpoint.bytes = written;
+            if (!part || !save_checkpoint(checkpoint_file, checkpoint)) {
+                logger.error("[BATCH][ERROR] " + tag + " Could not write checkpoint for " + input);
+                return 1;
+            }
+        }
+    }
+
+    // A read or decode error before the known end is a failure, not the end of the file:
+    // the retry resumes from the last checkpoint instead of marking it done
+    auto frame_count = source->get_frame_count();
+    if (frame_count >= 0 && checkpoint.frame < frame_count) {
+        logger.error("[BATCH][ERROR] " + tag + " Could not read frame " + std::to_string(checkpoint.frame) + " of " +
+                     std::to_string(frame_count) + " in " + input);
+        return 1;
+    }
+
+    part.flush();
+    checkpoint.bytes = written;
+    checkpoint.done = true;
+    if (!part || !save_checkpoint(checkpoint_file, checkpoint)) {
+        logger.error("[BATCH][ERROR] " + tag + " Could not write checkpoint for " + input);
+        return 1;
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    logger.info("[BATCH][INFO] " + tag + " Done: " + std::to_string(frames) + " frames (" +
+                std::to_string(seconds > 0 ? frames / seconds : 0.0) + " FPS), " +
+                std::to_string(checkpoint.detections) + " detections total");
+    return 0;
+}
+
+// Concatenates the parts in manifest order into <output>/detections.csv
+bool merge_parts(const std::string& output_dir, const std::vector<std::string>& inputs) {
+    auto merged_path = (std::filesystem::path(output_dir) / "detections.csv").string();
+    auto temporary = merged_path + ".tmp";
+    {
+        auto merged = std::ofstream(temporary, std::ios::binary | std::ios::trunc);
+        merged << "file,frame,timestamp_us,class_id,score,x1,y1,x2,y2\n";
+        auto line = std::string();
+        for (size_t job = 0; job < inputs.size(); ++job) {
+            auto part = std::ifstream(part_path(output_dir, static_cast<int64_t>(job)), std::ios::binary);
+            auto prefix = csv_quote(inputs[job]) + ",";
+            while (std::getline(part, line)) {
+                merged << prefix << line << '\n';
+            }
+        }
+        if (!merged.flush()) {
+            return false;
+        }
+    }
+    auto error = std::error_code();
+    std::filesystem::rename(temporary, merged_path, error);
+    return !error;
+}
+
+// Shards the manifest over pinned worker processes, one file per process at a time
+int run_coordinator(const BatchOptions& options, const std::vector<std::string>& inputs, const std::string& executable) {
+    auto error = std::error_code();
+    std::filesystem::create_directories(std::filesystem::path(options.output_dir) / "parts", error);
+    if (error) {
+        logger.error("[BATCH][ERROR] Could not create " + options.output_dir);
+        return 1;
+    }
+
+    // 1. Pending files: everything without a finished checkpoint
+    auto pending = std::deque<int64_t>();
+    auto resumed = 0;
+    for (size_t job = 0; job < inputs.size(); ++job) {
+        auto checkpoint = Checkpoint();
+        if (load_checkpoint(checkpoint_path(options.output_dir, static_cast<int64_t>(job)), inputs[job], checkpoint)) {
+            if (checkpoint.done) continue;
+            if (checkpoint.frame > 0) ++resumed;
+        }
+        pending.push_back(static_cast<int64_t>(job));
+    }
+
+    // 2. Worker slots, each pinned to its own core group
+    auto hardware_cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    auto num_workers = options.workers;
+    auto cores_per_worker = options.cores_per_worker;
+    if (num_workers <= 0) {
+        num_workers = std::max(1, hardware_cores / std::max(1, cores_per_worker > 0 ? cores_per_worker : 4));
+    }
+    if (cores_per_worker <= 0) {
+        cores_per_worker = std::max(1, hardware_cores / num_workers);
+    }
+    num_workers = std::max(1, std::min<int>(num_workers, static_cast<int>(pending.size())));
+
+    struct Slot {
+        ChildProcess process;
+        int64_t job = -1;
+        std::string cores;
+    };
+    auto slots = std::vector<Slot>(num_workers);
+    for (int i = 0; i < num_workers; ++i) {
+        auto first = (i * cores_per_worker) % hardware_cores;
+        auto last = std::min(first + cores_per_worker, hardware_cores) - 1;
+        slots[i].cores = std::to_string(first) + "-" + std::to_string(last);
+    }
+    std::cout << "[BATCH] " << inputs.size() << " files | " << pending.size() << " to process (" << resumed
+              << " resuming) | " << num_workers << " workers x " << cores_per_worker << " cores\n";
+
+    // 3. Keep every slot busy; a failed file is restarted from its checkpoint up to `retries` times
+    auto attempts = std::map<int64_t, int>();
+    auto failed = std::vector<int64_t>();
+    auto start = std::chrono::steady_clock::now();
+    auto running = 0;
+    while (!pending.empty() || running > 0) {
+        for (auto& slot : slots) {
+            if (slot.job >= 0 || pending.empty()) {
+                continue;
+            }
+            auto job = pending.front();
+            pending.pop_front();
+            auto args = std::vector<std::string>{executable, options.manifest, "--worker", "--job", std::to_string(job),
+                                                 "--output", options.output_dir, "--pin", slot.cores,
+                                                 "--checkpoint", std::to_string(options.checkpoint_frames)};
+            if (!options.model_path.empty()) args.insert(args.end(), {"--model", options.model_path});
+            if (!options.backend.empty()) args.insert(args.end(), {"--backend", options.backend});
+            if (!options.region.empty()) {
+                args.insert(args.end(), {"--region", std::to_string(options.region.width) + "x" + std::to_string(options.region.height)});
+            }
+            if (!slot.process.start(executable, args)) {
+                logger.error("[BATCH][ERROR] Could not start a worker for " + inputs[job]);
+                failed.push_back(job);
+                continue;
+            }
+            slot.job = job;
+            ++running;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        for (auto& slot : slots) {
+            auto exit_code = 0;
+            if (slot.job < 0 || !slot.process.poll(exit_code)) {
+                continue;
+            }
+            --running;
+            auto job = slot.job;
+            slot.job = -1;
+            if (exit_code == 0) {
+                std::cout << "[BATCH] Finished " << inputs[job] << "\n";
+            } else if (attempts[job]++ < options.retries) {
+                logger.warning("[BATCH][WARNING] " + inputs[job] + " failed (exit " + std::to_string(exit_code) + "), resuming");
+                pending.push_back(job);
+            } else {
+                logger.error("[BATCH][ERROR] " + inputs[job] + " failed (exit " + std::to_string(exit_code) + ")");
+                failed.push_back(job);
+            }
+        }
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // 4. Totals from the checkpoints, merged output once every file is done
+    auto frames = int64_t(0);
+    auto detections = int64_t(0);
+    for (size_t job = 0; job < inputs.size(); ++job) {
+        auto checkpoint = Checkpoint();
+        load_checkpoint(checkpoint_path(options.output_dir, static_cast<int64_t>(job)), inputs[job], checkpoint);
+        frames += checkpoint.frame;
+        detections += checkpoint.detections;
+    }
+    std::cout << std::fixed << std::setprecision(3) << "[BATCH] " << frames << " frames | " << detections
+              << " detections | " << seconds << " s this run\n";
+    if (!failed.empty()) {
+        std::cout << "[BATCH] " << failed.size() << " files failed; rerun to resume them\n";
+        return 1;
+    }
+    if (!merge_parts(options.output_dir, inputs)) {
+        logger.error("[BATCH][ERROR] Could not write the merged detections");
+        return 1;
+    }
+    std::cout << "[BATCH] Merged: " << (std::filesystem::path(options.output_dir) / "detections.csv").string() << "\n";
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    auto options = BatchOptions();
+    try {
+        if (!parse_options(argc, argv, options)) {
+            print_usage();
+            return 1;
+        }
+    } catch (const std::exception&) {
+        print_usage();
+        return 1;
+    }
+
+    auto inputs = read_manifest(options.manifest);
+    if (inputs.empty()) {
+        logger.error("[BATCH][ERROR] Manifest is empty or missing: " + options.manifest);
+        return 1;
+    }
+
+    try {
+        if (options.worker) {
+            return run_worker(options, inputs);
+        }
+
+        // [Batch] defaults for anything not given on the command line
+        auto config = ConfigManager("blood.cfg");
+        if (options.workers <= 0) options.workers = config.get_int("Batch", "workers", 0);
+        if (options.cores_per_worker <= 0) options.cores_per_worker = config.get_int("Batch", "cores_per_worker", 0);
+        if (options.checkpoint_frames <= 0) options.checkpoint_frames = config.get_int("Batch", "checkpoint_frames", 300);
+        if (options.retries < 0) options.retries = config.get_int("Batch", "retries", 1);
+        return run_coordinator(options, inputs, current_executable_path(argv[0]));
+    } catch (const std::exception& e) {
+        logger.error("[BATCH][ERROR] Exception captured: " + std::string(e.what()));
+        return 1;
+    }
+}
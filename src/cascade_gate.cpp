@@ -0,0 +1,118 @@
+#include "cascade_gate.hpp"
+#include "memory_tracker.hpp"
+#include <algorithm>
+#include <chrono>
+
+CascadeGate::CascadeGate(const CascadeOptions& cascade_options) : options(cascade_options) {
+    gate_model = std::make_unique<YOLOv8Model>(options.gate_model_path, 0.0f, 0.0f, std::max(1, options.gate_threads));
+    // Stretch: the gate only needs to know whether something is there
+    preprocessor.set_input_size(gate_model->get_input_width(), gate_model->get_input_height());
+    logger.info("[CascadeGate][INFO] Gate model " + options.gate_model_path + " (" +
+                std::to_string(gate_model->get_input_width()) + "x" + std::to_string(gate_model->get_input_height()) +
+                "), threshold " + std::to_string(options.gate_threshold) +
+                ", refresh every " + std::to_string(options.refresh_interval) + " frames" +
+                (options.audit ? " [audit]" : ""));
+}
+
+CascadeOptions CascadeGate::options_from_config(ConfigManager& config) {
+    auto result = CascadeOptions();
+    result.enabled = config.get_string("Cascade", "enabled", "false") == "true";
+    result.gate_model_path = config.get_string("Cascade", "gate_model_path", result.gate_model_path);
+    result.gate_threshold = config.get_float("Cascade", "gate_threshold", result.gate_threshold);
+    result.refresh_interval = std::max(0, config.get_int("Cascade", "refresh_interval", result.refresh_interval));
+    result.hold_frames = std::max(0, config.get_int("Cascade", "hold_frames", result.hold_frames));
+    result.gate_threads = config.get_int("Cascade", "gate_threads", result.gate_threads);
+    result.audit = config.get_string("Cascade", "audit", "false") == "true";
+    return result;
+}
+
+float CascadeGate::gate_score(const cv::Mat& image) {
+    auto scope = StageScope(PipelineStage::Gate);
+    auto outputs = InferenceOutput();
+    if (gate_model->has_uint8_input()) {
+        const auto& input_image = preprocessor.prepare_input_u8(image);
+        if (input_image.empty()) return 0.0f;
+        outputs = gate_model->run_inference(input_image);
+    } else {
+        const auto& input_tensor = preprocessor.prepare_input(image);
+        if (input_tensor.empty()) return 0.0f;
+        outputs = gate_model->run_inference(input_tensor);
+    }
+    if (outputs.empty()) return 0.0f;
+
+    const auto& shape = outputs[0].shape;
+    auto data = outputs[0].data;
+    auto score = 0.0f;
+
+    if (shape.size() == 2 && shape[1] == 6) {
+        // In-graph NMS rows: x1, y1, x2, y2, score, class
+        for (int64_t i = 0; i < shape[0]; ++i) {
+            score = std::max(score, data[i * 6 + 4]);
+        }
+    } else if (shape.size() == 2) {
+        // Classifier: single object probability, or class 0 = empty
+        auto classes = shape[1];
+        if (classes == 1) {
+            score = data[0];
+        } else {
+            for (int64_t c = 1; c < classes; ++c) {
+                score = std::max(score, data[c]);
+            }
+        }
+    } else if (shape.size() == 3) {
+        // YOLOv8 head [1, 4+C, N] (or transposed [1, N, 4+C])
+        auto transposed = shape[1] > shape[2];
+        auto channels = transposed ? shape[2] : shape[1];
+        auto anchors = transposed ? shape[1] : shape[2];
+        for (int64_t c = 4; c < channels; ++c) {
+            for (int64_t a = 0; a < anchors; ++a) {
+                score = std::max(score, transposed ? data[a * channels + c] : data[c * anchors + a]);
+            }
+        }
+    } else {
+        logger.warning("[CascadeGate][WARNING] Unsupported gate output rank, passing frame to the full detector");
+        score = 1.0f;
+    }
+    return score;
+}
+
+CascadeDecision CascadeGate::evaluate(const cv::Mat& image) {
+    auto start = std::chrono::steady_clock::now();
+    auto decision = CascadeDecision();
+    decision.gate_score = gate_score(image);
+    stats.gate_ms_total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    ++stats.frames;
+    ++frames_since_full;
+    decision.gate_fired = decision.gate_score >= options.gate_threshold;
+    decision.held = !decision.gate_fired && hold_remaining > 0;
+    decision.refresh = !decision.gate_fired && !decision.held &&
+                       options.refresh_interval > 0 && frames_since_full >= options.refresh_interval;
+    hold_remaining = std::max(0, hold_remaining - 1);
+
+    decision.skipped = !decision.gate_fired && !decision.held && !decision.refresh;
+    decision.run_full = !decision.skipped || options.audit;
+
+    if (decision.gate_fired) ++stats.gate_fired;
+    if (decision.held) ++stats.held;
+    if (decision.refresh) ++stats.refreshes;
+    if (decision.skipped) ++stats.skipped;
+    return decision;
+}
+
+void CascadeGate::record(const CascadeDecision& decision, size_t num_detections) {
+    ++stats.full_runs;
+    if (!decision.gate_fired) {
+        ++stats.negatives_checked;
+        if (num_detections > 0) ++stats.gate_misses;
+    }
+    // Audit runs on skipped frames are observations only: the cascade state evolves as if they never ran
+    if (decision.skipped) {
+        if (num_detections > 0) ++stats.skipped_with_detections;
+        return;
+    }
+    frames_since_full = 0;
+    if (num_detections > 0) {
+        hold_remaining = options.hold_frames;
+    }
+}
@@ -0,0 +1,233 @@
+#include "child_process.hpp"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <climits>
+#include <csignal>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/prctl.h>
+#endif
+extern char** environ;
+#endif
+
+#ifdef _WIN32
+
+namespace {
+
+// CommandLineToArgvW quoting: backslashes are literal unless they precede a quote
+std::string quote_argument(const std::string& arg) {
+    if (!arg.empty() && arg.find_first_of(" \t\"") == std::string::npos) {
+        return arg;
+    }
+    auto quoted = std::string("\"");
+    auto backslashes = size_t(0);
+    for (auto c : arg) {
+        if (c == '\\') {
+            ++backslashes;
+            continue;
+        }
+        quoted.append(c == '"' ? backslashes * 2 + 1 : backslashes, '\\');
+        backslashes = 0;
+        quoted.push_back(c);
+    }
+    quoted.append(backslashes * 2, '\\');
+    quoted.push_back('"');
+    return quoted;
+}
+
+// Every child joins one kill-on-close job: when this process dies, however it dies,
+// the system closes the last handle and terminates the children with it
+HANDLE children_job() {
+    static auto job = [] {
+        auto handle = CreateJobObjectA(nullptr, nullptr);
+        auto limits = JOBOBJECT_EXTENDED_LIMIT_INFORMATION();
+        limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+        if (handle && !SetInformationJobObject(handle, JobObjectExtendedLimitInformation, &limits, sizeof(limits))) {
+            CloseHandle(handle);
+            handle = nullptr;
+        }
+        return handle;
+    }();
+    return job;
+}
+
+}
+
+ChildProcess::~ChildProcess() {
+    if (process_handle) {
+        terminate();
+        WaitForSingleObject(process_handle, INFINITE);
+        CloseHandle(process_handle);
+    }
+}
+
+bool ChildProcess::start(const std::string& executable, const std::vector<std::string>& args) {
+    if (process_handle) {
+        return false;
+    }
+    auto command_line = std::string();
+    for (const auto& arg : args) {
+        if (!command_line.empty()) command_line.push_back(' ');
+        command_line += quote_argument(arg);
+    }
+    auto startup_info = STARTUPINFOA();
+    startup_info.cb = sizeof(startup_info);
+    auto process_info = PROCESS_INFORMATION();
+    // Suspended until it is in the job, so it cannot start a grandchild outside of it
+    if (!CreateProcessA(executable.c_str(), &command_line[0], nullptr, nullptr, FALSE, CREATE_SUSPENDED, nullptr, nullptr,
+                        &startup_info, &process_info)) {
+        return false;
+    }
+    if (auto job = children_job()) {
+        AssignProcessToJobObject(job, process_info.hProcess);
+    }
+    ResumeThread(process_info.hThread);
+    CloseHandle(process_info.hThread);
+    process_handle = process_info.hProcess;
+    return true;
+}
+
+bool ChildProcess::is_running() const {
+    return process_handle && WaitForSingleObject(process_handle, 0) == WAIT_TIMEOUT;
+}
+
+bool ChildProcess::poll(int& exit_code) {
+    if (!process_handle || WaitForSingleObject(process_handle, 0) != WAIT_OBJECT_0) {
+        return false;
+    }
+    auto code = DWORD(0);
+    exit_code = GetExitCodeProcess(process_handle, &code) ? static_cast<int>(code) : -1;
+    CloseHandle(process_handle);
+    process_handle = nullptr;
+    return true;
+}
+
+void ChildProcess::terminate() {
+    if (process_handle) {
+        TerminateProcess(process_handle, 1);
+    }
+}
+
+bool pin_current_process(const std::vector<int>& cores) {
+    auto mask = DWORD_PTR(0);
+    for (auto core : cores) {
+        if (core >= 0 && core < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+            mask |= DWORD_PTR(1) << core;
+        }
+    }
+    return mask != 0 && SetProcessAffinityMask(GetCurrentProcess(), mask);
+}
+
+bool exit_with_parent() {
+    // Children started by ChildProcess are already in its kill-on-close job
+    return children_job() != nullptr;
+}
+
+std::string current_executable_path(const char* argv0) {
+    char path[MAX_PATH];
+    auto length = GetModuleFileNameA(nullptr, path, MAX_PATH);
+    return length > 0 && length < MAX_PATH ? std::string(path, length) : std::string(argv0);
+}
+
+#else
+
+ChildProcess::~ChildProcess() {
+    if (pid > 0) {
+        terminate();
+        auto status = 0;
+        waitpid(pid, &status, 0);
+    }
+}
+
+bool ChildProcess::start(const std::string& executable, const std::vector<std::string>& args) {
+    if (pid > 0) {
+        return false;
+    }
+    auto argv = std::vector<char*>();
+    for (const auto& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+    auto child = pid_t(-1);
+    if (posix_spawn(&child, executable.c_str(), nullptr, nullptr, argv.data(), environ) != 0) {
+        return false;
+    }
+    pid = child;
+    return true;
+}
+
+bool ChildProcess::is_running() const {
+    return pid > 0;
+}
+
+bool ChildProcess::poll(int& exit_code) {
+    if (pid <= 0) {
+        return false;
+    }
+    auto status = 0;
+    if (waitpid(pid, &status, WNOHANG) != pid) {
+        return false;
+    }
+    exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    pid = -1;
+    return true;
+}
+
+void ChildProcess::terminate() {
+    if (pid > 0) {
+        kill(pid, SIGTERM);
+    }
+}
+
+bool pin_current_process(const std::vector<int>& cores) {
+#ifdef __linux__
+    auto set = cpu_set_t();
+    CPU_ZERO(&set);
+    auto any = false;
+    for (auto core : cores) {
+        if (core >= 0 && core < CPU_SETSIZE) {
+            CPU_SET(core, &set);
+            any = true;
+        }
+    }
+    return any && sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cores;
+    return false;
+#endif
+}
+
+bool exit_with_parent() {
+#ifdef __linux__
+    if (prctl(PR_SET_PDEATHSIG, SIGTERM) != 0) {
+        return false;
+    }
+    // The parent may have died before the request: the process was already reparented to init
+    if (getppid() == 1) {
+        std::raise(SIGTERM);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::string current_executable_path(const char* argv0) {
+#ifdef __linux__
+    char path[PATH_MAX];
+    auto length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length > 0) {
+        return std::string(path, static_cast<size_t>(length));
+    }
+#endif
+    return std::string(argv0);
+}
+
+#endif
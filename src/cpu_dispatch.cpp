@@ -0,0 +1,157 @@
+#include "cpu_dispatch.hpp"
+#include <cstdlib>
+
+#if defined(DOGAI_X86_KERNELS)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+std::atomic<const CpuKernels*> CpuDispatch::active{nullptr};
+
+namespace {
+
+#if defined(DOGAI_X86_KERNELS)
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<uint32_t>(values[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Register state the OS saves on context switches (XCR0)
+uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+const CpuKernels& table_for(CpuIsa isa) {
+#if defined(DOGAI_X86_KERNELS)
+    switch (isa) {
+        case CpuIsa::AVX512: return cpu_kernels_avx512();
+        case CpuIsa::AVX2: return cpu_kernels_avx2();
+        case CpuIsa::SSE42: return cpu_kernels_sse42();
+        default: break;
+    }
+#endif
+    (void)isa;
+    return cpu_kernels_generic();
+}
+
+}
+
+CpuIsa CpuDispatch::detect() {
+    auto result = CpuIsa::Generic;
+#if defined(DOGAI_X86_KERNELS)
+    uint32_t regs[4];
+    cpuid(0, 0, regs);
+    auto max_leaf = regs[0];
+    if (max_leaf < 1) return result;
+
+    cpuid(1, 0, regs);
+    auto sse42 = (regs[2] >> 20) & 1;
+    auto fma = (regs[2] >> 12) & 1;
+    auto osxsave = (regs[2] >> 27) & 1;
+    auto avx = (regs[2] >> 28) & 1;
+    if (!sse42) return result;
+    result = CpuIsa::SSE42;
+
+    // AVX state (XMM|YMM) and AVX-512 state (opmask|ZMM_Hi256|Hi16_ZMM) must be enabled by the OS
+    auto xcr0 = osxsave ? xgetbv0() : 0;
+    if (!avx || (xcr0 & 0x6) != 0x6 || max_leaf < 7) return result;
+
+    cpuid(7, 0, regs);
+    auto avx2 = (regs[1] >> 5) & 1;
+    if (!avx2 || !fma) return result;
+    result = CpuIsa::AVX2;
+
+    auto avx512 = ((regs[1] >> 16) & 1) && ((regs[1] >> 17) & 1) && ((regs[1] >> 30) & 1) && ((regs[1] >> 31) & 1);
+    if (avx512 && (xcr0 & 0xE6) == 0xE6) {
+        result = CpuIsa::AVX512;
+    }
+#endif
+    return result;
+}
+
+const char* CpuDispatch::isa_name(CpuIsa isa) {
+    switch (isa) {
+        case CpuIsa::SSE42: return "sse42";
+        case CpuIsa::AVX2: return "avx2";
+        case CpuIsa::AVX512: return "avx512";
+        default: return "generic";
+    }
+}
+
+bool CpuDispatch::parse_isa(const std::string& value, CpuIsa& isa, bool& automatic) {
+    automatic = value.empty() || value == "auto";
+    if (automatic) return true;
+    for (auto candidate : {CpuIsa::Generic, CpuIsa::SSE42, CpuIsa::AVX2, CpuIsa::AVX512}) {
+        if (value == isa_name(candidate)) {
+            isa = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+CpuIsa CpuDispatch::select(CpuIsa requested) {
+    auto detected = detect();
+    auto isa = static_cast<int>(requested) > static_cast<int>(detected) ? detected : requested;
+    if (isa != requested) {
+        logger.warning(std::string("[CpuDispatch][WARNING] ") + isa_name(requested) + " kernels not supported by this CPU, using " + isa_name(isa));
+    }
+    active.store(&table_for(isa), std::memory_order_release);
+    return isa;
+}
+
+void CpuDispatch::configure(ConfigManager& config) {
+    auto value = config.get_string("CPU", "kernel_isa", "auto");
+    if (config.get_string("CPU", "enable_simd", "true") != "true") {
+        value = "generic";
+    }
+    if (auto env = std::getenv("DOGAI_CPU_ISA")) {
+        value = env;
+    }
+
+    auto isa = CpuIsa::Generic;
+    auto automatic = true;
+    if (!parse_isa(value, isa, automatic)) {
+        logger.warning("[CpuDispatch][WARNING] Unknown kernel ISA '" + value + "', using auto");
+        automatic = true;
+    }
+    if (automatic) {
+        select(detect());
+    } else {
+        select(isa);
+    }
+    logger.info("[CpuDispatch][INFO] Kernels: " + describe());
+}
+
+const CpuKernels& CpuDispatch::initialize() {
+    // No configure() call: best supported variant. Racing first calls pick the same table.
+    auto& table = table_for(detect());
+    const CpuKernels* expected = nullptr;
+    active.compare_exchange_strong(expected, &table, std::memory_order_acq_rel);
+    return *active.load(std::memory_order_acquire);
+}
+
+std::string CpuDispatch::describe() {
+    auto& table = kernels();
+    auto result = std::string(table.name);
+    auto detected = detect();
+    if (table.isa != detected) {
+        result += std::string(" (detected ") + isa_name(detected) + ", override)";
+    }
+    return result;
+}
@@ -0,0 +1,215 @@
+// Kernel bodies shared by every instruction-set variant. Each
+// src/cpu_kernels_<isa>.cpp defines DOGAI_KERNEL_ISA, DOGAI_KERNEL_NAME and
+// DOGAI_KERNEL_TABLE and includes this file; the build compiles that file with
+// the matching target flags. Plain loops are left to the compiler's vectorizer
+// for that target, the score scan and byte sums use intrinsics directly.
+//
+// Only intrinsics and internal-linkage helpers may be used here: an inline
+// function from a shared header would be emitted with this file's target flags
+// and the linker could pick that copy for baseline code.
+
+#include "cpu_kernels.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define DOGAI_KERNEL_SSE2 1
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+inline float min_f(float a, float b) { return a < b ? a : b; }
+inline float max_f(float a, float b) { return a > b ? a : b; }
+
+inline int count_trailing_zeros(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Appends base + bit for every set bit of mask
+inline int append_mask(uint32_t mask, int base, int* indices, int n) {
+    while (mask) {
+        indices[n++] = base + count_trailing_zeros(mask);
+        mask &= mask - 1;
+    }
+    return n;
+}
+
+void bilinear_row_planar(const uint8_t* row0, const uint8_t* row1, const int* x0_offsets, const int* x1_offsets,
+                         const float* x_weights, float wy0, float wy1, int width,
+                         float* __restrict b_out, float* __restrict g_out, float* __restrict r_out) {
+    for (int dx = 0; dx < width; ++dx) {
+        auto p00 = row0 + x0_offsets[dx];
+        auto p01 = row0 + x1_offsets[dx];
+        auto p10 = row1 + x0_offsets[dx];
+        auto p11 = row1 + x1_offsets[dx];
+        auto wx1 = x_weights[dx];
+        auto wx0 = 1.0f - wx1;
+        auto w00 = wx0 * wy0, w01 = wx1 * wy0, w10 = wx0 * wy1, w11 = wx1 * wy1;
+        b_out[dx] = p00[0] * w00 + p01[0] * w01 + p10[0] * w10 + p11[0] * w11;
+        g_out[dx] = p00[1] * w00 + p01[1] * w01 + p10[1] * w10 + p11[1] * w11;
+        r_out[dx] = p00[2] * w00 + p01[2] * w01 + p10[2] * w10 + p11[2] * w11;
+    }
+}
+
+void bilinear_row_bgr(const uint8_t* row0, const uint8_t* row1, const int* x0_offsets, const int* x1_offsets,
+                      const float* x_weights, float wy0, float wy1, int width, uint8_t* __restrict out) {
+    for (int dx = 0; dx < width; ++dx, out += 3) {
+        auto p00 = row0 + x0_offsets[dx];
+        auto p01 = row0 + x1_offsets[dx];
+        auto p10 = row1 + x0_offsets[dx];
+        auto p11 = row1 + x1_offsets[dx];
+        auto wx1 = x_weights[dx];
+        auto wx0 = 1.0f - wx1;
+        auto w00 = wx0 * wy0, w01 = wx1 * wy0, w10 = wx0 * wy1, w11 = wx1 * wy1;
+        for (int c = 0; c < 3; ++c) {
+            out[c] = static_cast<uint8_t>(p00[c] * w00 + p01[c] * w01 + p10[c] * w10 + p11[c] * w11 + 0.5f);
+        }
+    }
+}
+
+int scan_scores(const float* scores, int count, float threshold, int* indices) {
+    auto n = 0;
+    auto i = 0;
+#if defined(__AVX512F__)
+    auto limit = _mm512_set1_ps(threshold);
+    auto lane_index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    auto step = _mm512_set1_epi32(16);
+    for (; i + 16 <= count; i += 16) {
+        auto mask = _mm512_cmp_ps_mask(_mm512_loadu_ps(scores + i), limit, _CMP_GT_OQ);
+        if (mask) {
+            _mm512_mask_compressstoreu_epi32(indices + n, mask, lane_index);
+#ifdef _MSC_VER
+            n += static_cast<int>(__popcnt(mask));
+#else
+            n += __builtin_popcount(mask);
+#endif
+        }
+        lane_index = _mm512_add_epi32(lane_index, step);
+    }
+#elif defined(__AVX__)
+    auto limit = _mm256_set1_ps(threshold);
+    for (; i + 8 <= count; i += 8) {
+        auto mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(scores + i), limit, _CMP_GT_OQ)));
+        n = append_mask(mask, i, indices, n);
+    }
+#elif defined(DOGAI_KERNEL_SSE2)
+    auto limit = _mm_set1_ps(threshold);
+    for (; i + 4 <= count; i += 4) {
+        auto mask = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(scores + i), limit)));
+        n = append_mask(mask, i, indices, n);
+    }
+#endif
+    for (; i < count; ++i) {
+        indices[n] = i;
+        n += scores[i] > threshold ? 1 : 0;
+    }
+    return n;
+}
+
+void class_argmax(const float* planes, int num_classes, int num_boxes, float* __restrict best_score, int* __restrict best_class) {
+    for (int i = 0; i < num_boxes; ++i) {
+        best_score[i] = planes[i];
+        best_class[i] = 0;
+    }
+    for (int c = 1; c < num_classes; ++c) {
+        const float* plane = planes + static_cast<size_t>(c) * num_boxes;
+        for (int i = 0; i < num_boxes; ++i) {
+            auto better = plane[i] > best_score[i];
+            best_score[i] = better ? plane[i] : best_score[i];
+            best_class[i] = better ? c : best_class[i];
+        }
+    }
+}
+
+void suppress_overlaps(const BoxArrays& boxes, int kept, int begin, int end, float threshold, uint8_t* __restrict suppressed) {
+    auto kx1 = boxes.x1[kept], ky1 = boxes.y1[kept], kx2 = boxes.x2[kept], ky2 = boxes.y2[kept];
+    auto karea = boxes.area[kept];
+    const float* __restrict x1 = boxes.x1;
+    const float* __restrict y1 = boxes.y1;
+    const float* __restrict x2 = boxes.x2;
+    const float* __restrict y2 = boxes.y2;
+    const float* __restrict area = boxes.area;
+
+    // Float IoU over the Detection corners, branch-free so it vectorizes. Two empty
+    // boxes give 0/0 = NaN, which never counts as an overlap
+    if (boxes.class_id) {
+        const int* __restrict class_id = boxes.class_id;
+        auto kclass = class_id[kept];
+        for (int j = begin; j < end; ++j) {
+            auto w = min_f(kx2, x2[j]) - max_f(kx1, x1[j]);
+            auto h = min_f(ky2, y2[j]) - max_f(ky1, y1[j]);
+            auto inter = (w > 0.0f && h > 0.0f) ? w * h : 0.0f;
+            auto overlap = inter / (karea + area[j] - inter) > threshold && class_id[j] == kclass;
+            suppressed[j] |= overlap ? 1 : 0;
+        }
+    } else {
+        for (int j = begin; j < end; ++j) {
+            auto w = min_f(kx2, x2[j]) - max_f(kx1, x1[j]);
+            auto h = min_f(ky2, y2[j]) - max_f(ky1, y1[j]);
+            auto inter = (w > 0.0f && h > 0.0f) ? w * h : 0.0f;
+            auto overlap = inter / (karea + area[j] - inter) > threshold;
+            suppressed[j] |= overlap ? 1 : 0;
+        }
+    }
+}
+
+uint32_t sum_bytes(const uint8_t* data, size_t count) {
+    auto sum = uint64_t(0);
+    auto i = size_t(0);
+    // SAD against zero adds 8 bytes per 64-bit lane per instruction
+#if defined(__AVX512BW__)
+    auto zero = _mm512_setzero_si512();
+    auto acc = _mm512_setzero_si512();
+    for (; i + 64 <= count; i += 64) {
+        acc = _mm512_add_epi64(acc, _mm512_sad_epu8(_mm512_loadu_si512(data + i), zero));
+    }
+    uint64_t lanes[8];
+    _mm512_storeu_si512(lanes, acc);
+    for (int lane = 0; lane < 8; ++lane) {
+        sum += lanes[lane];
+    }
+#elif defined(__AVX2__)
+    auto zero = _mm256_setzero_si256();
+    auto acc = _mm256_setzero_si256();
+    for (; i + 32 <= count; i += 32) {
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), zero));
+    }
+    auto half = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum += static_cast<uint64_t>(_mm_cvtsi128_si32(half)) + static_cast<uint64_t>(_mm_cvtsi128_si32(_mm_srli_si128(half, 8)));
+#elif defined(DOGAI_KERNEL_SSE2)
+    auto zero = _mm_setzero_si128();
+    auto acc = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), zero));
+    }
+    sum += static_cast<uint64_t>(_mm_cvtsi128_si32(acc)) + static_cast<uint64_t>(_mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+#endif
+    for (; i < count; ++i) {
+        sum += data[i];
+    }
+    return static_cast<uint32_t>(sum);
+}
+
+}
+
+const CpuKernels& DOGAI_KERNEL_TABLE() {
+    static const CpuKernels table = {
+        DOGAI_KERNEL_ISA,
+        DOGAI_KERNEL_NAME,
+        bilinear_row_planar,
+        bilinear_row_bgr,
+        scan_scores,
+        class_argmax,
+        suppress_overlaps,
+        sum_bytes,
+    };
+    return table;
+}
@@ -0,0 +1,5 @@
+// Kernel variant for CpuIsa::AVX2; target flags are set per file in CMakeLists.txt
+#define DOGAI_KERNEL_ISA CpuIsa::AVX2
+#define DOGAI_KERNEL_NAME "avx2"
+#define DOGAI_KERNEL_TABLE cpu_kernels_avx2
+#include "cpu_kernels.inl"
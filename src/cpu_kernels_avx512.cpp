@@ -0,0 +1,5 @@
+// Kernel variant for CpuIsa::AVX512; target flags are set per file in CMakeLists.txt
+#define DOGAI_KERNEL_ISA CpuIsa::AVX512
+#define DOGAI_KERNEL_NAME "avx512"
+#define DOGAI_KERNEL_TABLE cpu_kernels_avx512
+#include "cpu_kernels.inl"
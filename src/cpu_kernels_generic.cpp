@@ -0,0 +1,5 @@
+// Kernel variant for CpuIsa::Generic; target flags are set per file in CMakeLists.txt
+#define DOGAI_KERNEL_ISA CpuIsa::Generic
+#define DOGAI_KERNEL_NAME "generic"
+#define DOGAI_KERNEL_TABLE cpu_kernels_generic
+#include "cpu_kernels.inl"
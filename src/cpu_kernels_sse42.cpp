@@ -0,0 +1,5 @@
+// Kernel variant for CpuIsa::SSE42; target flags are set per file in CMakeLists.txt
+#define DOGAI_KERNEL_ISA CpuIsa::SSE42
+#define DOGAI_KERNEL_NAME "sse42"
+#define DOGAI_KERNEL_TABLE cpu_kernels_sse42
+#include "cpu_kernels.inl"
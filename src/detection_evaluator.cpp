@@ -0,0 +1,236 @@
+#include "detection_evaluator.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+namespace {
+
+float box_iou(const Detection& a, const Detection& b) {
+    auto inter_w = std::min(a.x2, b.x2) - std::max(a.x1, b.x1);
+    auto inter_h = std::min(a.y2, b.y2) - std::max(a.y1, b.y1);
+    if (inter_w <= 0.0f || inter_h <= 0.0f) {
+        return 0.0f;
+    }
+    auto inter = inter_w * inter_h;
+    auto union_area = a.area() + b.area() - inter;
+    return union_area > 0.0f ? inter / union_area : 0.0f;
+}
+
+}
+
+void DetectionEvaluator::add_image(Span<const Detection> predictions, Span<const Detection> ground_truth) {
+    ++images;
+    for (const auto& label : ground_truth) {
+        ++ground_truth_counts[label.class_id];
+    }
+
+    // 1. Predictions by decreasing score, IoU against every label of the same class (-1 otherwise)
+    auto num_predictions = predictions.size();
+    auto num_labels = ground_truth.size();
+    order.resize(num_predictions);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return predictions[a].score > predictions[b].score; });
+    ious.assign(num_predictions * num_labels, -1.0f);
+    for (size_t p = 0; p < num_predictions; ++p) {
+        for (size_t g = 0; g < num_labels; ++g) {
+            if (predictions[p].class_id == ground_truth[g].class_id) {
+                ious[p * num_labels + g] = box_iou(predictions[p], ground_truth[g]);
+            }
+        }
+    }
+
+    auto base = outcomes.size();
+    for (auto p : order) {
+        outcomes.push_back(Outcome{predictions[p].score, predictions[p].class_id, 0});
+    }
+
+    // 2. Greedy matching per threshold: each label is claimed by the best-scoring prediction that overlaps it enough
+    for (int t = 0; t < NUM_IOU_THRESHOLDS; ++t) {
+        auto threshold = iou_threshold(t);
+        matched.assign(num_labels, 0);
+        for (size_t k = 0; k < num_predictions; ++k) {
+            const auto* row = ious.data() + static_cast<size_t>(order[k]) * num_labels;
+            auto best = -1;
+            auto best_iou = -1.0f;
+            for (size_t g = 0; g < num_labels; ++g) {
+                if (!matched[g] && row[g] >= threshold && row[g] > best_iou) {
+                    best = static_cast<int>(g);
+                    best_iou = row[g];
+                }
+            }
+            if (best >= 0) {
+                matched[best] = 1;
+                outcomes[base + k].true_positive |= static_cast<uint16_t>(1u << t);
+            }
+        }
+    }
+}
+
+void DetectionEvaluator::merge(const DetectionEvaluator& other) {
+    outcomes.insert(outcomes.end(), other.outcomes.begin(), other.outcomes.end());
+    for (const auto& entry : other.ground_truth_counts) {
+        ground_truth_counts[entry.first] += entry.second;
+    }
+    images += other.images;
+}
+
+double DetectionEvaluator::average_precision(std::vector<const Outcome*>& sorted, int ground_truth, int threshold,
+                                             double* precision, double* recall) {
+    if (ground_truth <= 0) {
+        return 0.0;
+    }
+    auto n = sorted.size();
+    auto precisions = std::vector<double>(n);
+    auto recalls = std::vector<double>(n);
+    auto tp = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        tp += (sorted[i]->true_positive >> threshold) & 1u;
+        recalls[i] = tp / ground_truth;
+        precisions[i] = tp / (i + 1);
+    }
+    if (precision) *precision = n > 0 ? precisions.back() : 0.0;
+    if (recall) *recall = n > 0 ? recalls.back() : 0.0;
+
+    // Precision envelope, sampled at recall 0.00, 0.01, ... 1.00
+    for (size_t i = n; i-- > 1;) {
+        precisions[i - 1] = std::max(precisions[i - 1], precisions[i]);
+    }
+    auto sum = 0.0;
+    auto index = size_t(0);
+    for (int r = 0; r <= 100; ++r) {
+        auto target = r / 100.0;
+        while (index < n && recalls[index] < target) {
+            ++index;
+        }
+        if (index == n) {
+            break;
+        }
+        sum += precisions[index];
+    }
+    return sum / 101.0;
+}
+
+AccuracyReport DetectionEvaluator::evaluate() const {
+    auto report = AccuracyReport();
+    report.images = images;
+
+    auto by_class = std::map<int, std::vector<const Outcome*>>();
+    for (const auto& entry : ground_truth_counts) {
+        by_class[entry.first];
+    }
+    for (const auto& outcome : outcomes) {
+        by_class[outcome.class_id].push_back(&outcome);
+    }
+
+    auto labeled_classes = 0;
+    for (auto& entry : by_class) {
+        auto& sorted = entry.second;
+        // Equal scores put misses first: the result does not depend on which worker saw which image
+        std::sort(sorted.begin(), sorted.end(), [](const Outcome* a, const Outcome* b) {
+            return a->score != b->score ? a->score > b->score : a->true_positive < b->true_positive;
+        });
+
+        auto accuracy = ClassAccuracy();
+        accuracy.class_id = entry.first;
+        auto count = ground_truth_counts.find(entry.first);
+        accuracy.ground_truth = count != ground_truth_counts.end() ? count->second : 0;
+        accuracy.predictions = static_cast<int>(sorted.size());
+        accuracy.ap50 = average_precision(sorted, accuracy.ground_truth, 0, &accuracy.precision, &accuracy.recall);
+        accuracy.ap50_95 = accuracy.ap50;
+        for (int t = 1; t < NUM_IOU_THRESHOLDS; ++t) {
+            accuracy.ap50_95 += average_precision(sorted, accuracy.ground_truth, t);
+        }
+        accuracy.ap50_95 /= NUM_IOU_THRESHOLDS;
+
+        if (accuracy.ground_truth > 0) {
+            report.map50 += accuracy.ap50;
+            report.map50_95 += accuracy.ap50_95;
+            ++labeled_classes;
+        }
+        report.classes.push_back(accuracy);
+    }
+    if (labeled_classes > 0) {
+        report.map50 /= labeled_classes;
+        report.map50_95 /= labeled_classes;
+    }
+    return report;
+}
+
+bool DetectionEvaluator::load_yolo_labels(const std::string& path, const cv::Size& image_size, std::vector<Detection>& labels) {
+    labels.clear();
+    auto file = std::ifstream(path);
+    if (!file.is_open()) {
+        // Unlabeled image: background only
+        return true;
+    }
+
+    auto line = std::string();
+    auto values = std::vector<float>();
+    while (std::getline(file, line)) {
+        auto stream = std::istringstream(line);
+        auto class_id = 0;
+        if (!(stream >> class_id)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            return false;
+        }
+        values.clear();
+        auto value = 0.0f;
+        while (stream >> value) {
+            values.push_back(value);
+        }
+        if (values.size() < 4 || (values.size() > 4 && values.size() % 2 != 0)) {
+            return false;
+        }
+
+        auto label = Detection();
+        label.score = 1.0f;
+        label.class_id = class_id;
+        if (values.size() == 4) {
+            label.x1 = (values[0] - values[2] * 0.5f) * image_size.width;
+            label.y1 = (values[1] - values[3] * 0.5f) * image_size.height;
+            label.x2 = (values[0] + values[2] * 0.5f) * image_size.width;
+            label.y2 = (values[1] + values[3] * 0.5f) * image_size.height;
+        } else {
+            // Segment polygon
+            auto min_x = values[0], max_x = values[0];
+            auto min_y = values[1], max_y = values[1];
+            for (size_t i = 2; i + 1 < values.size(); i += 2) {
+                min_x = std::min(min_x, values[i]);
+                max_x = std::max(max_x, values[i]);
+                min_y = std::min(min_y, values[i + 1]);
+                max_y = std::max(max_y, values[i + 1]);
+            }
+            label.x1 = min_x * image_size.width;
+            label.y1 = min_y * image_size.height;
+            label.x2 = max_x * image_size.width;
+            label.y2 = max_y * image_size.height;
+        }
+        labels.push_back(label);
+    }
+    return true;
+}
+
+std::string DetectionEvaluator::label_path_for(const std::string& image_path, const std::string& labels_dir) {
+    auto image = std::filesystem::path(image_path);
+    if (!labels_dir.empty()) {
+        return (std::filesystem::path(labels_dir) / image.stem()).string() + ".txt";
+    }
+
+    // Ultralytics layout: <root>/images/<split>/x.jpg -> <root>/labels/<split>/x.txt
+    auto parts = std::vector<std::filesystem::path>(image.begin(), image.end());
+    for (auto i = static_cast<int>(parts.size()) - 2; i >= 0; --i) {
+        if (parts[i] == "images") {
+            parts[i] = "labels";
+            auto result = std::filesystem::path();
+            for (const auto& part : parts) {
+                result /= part;
+            }
+            return result.replace_extension(".txt").string();
+        }
+    }
+    return std::filesystem::path(image).replace_extension(".txt").string();
+}
@@ -0,0 +1,147 @@
+#include "detection_server.hpp"
+#include "metrics.hpp"
+#include "process_memory.hpp"
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <numeric>
+
+namespace {
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    auto index = static_cast<size_t>(p * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+}
+
+DetectionServer::DetectionServer(const std::string& model_path, int num_workers, int num_sessions,
+                                 const std::string& backend)
+    : config("blood.cfg") {
+    if (!backend.empty()) {
+        config.set_string("Model", "backend", backend);
+    }
+    if (num_workers <= 0) {
+        num_workers = config.get_int("Server", "num_workers", 4);
+    }
+    if (num_sessions <= 0) {
+        num_sessions = config.get_int("Server", "num_sessions", 1);
+    }
+    num_workers = std::max(1, num_workers);
+    num_sessions = std::max(1, std::min(num_sessions, num_workers));
+    auto intra_op_threads = config.get_int("Server", "intra_op_threads", 1);
+
+    // 1. Sessions: workers share them round-robin and call Run concurrently.
+    //    ORT prepacks weights while a session is initialized, so the first one is created
+    //    alone and fills the shared container; its warmup then runs in parallel with the
+    //    creation and warmup of the rest, which reuse the packed weights.
+    auto warmup_iterations = YOLOv8Model::warmup_iterations_from_config(config);
+    auto rss_start = current_rss_bytes();
+    sessions.push_back(std::make_shared<YOLOv8Model>(model_path, config, 0.2f, 0.2f, intra_op_threads));
+    auto rss_first = current_rss_bytes();
+
+    auto first_warmup = std::async(std::launch::async, [session = sessions.front(), warmup_iterations] {
+        session->warmup(warmup_iterations);
+    });
+    auto session_init = std::vector<std::future<std::shared_ptr<YOLOv8Model>>>();
+    for (int i = 1; i < num_sessions; ++i) {
+        session_init.push_back(std::async(std::launch::async, [this, &model_path, intra_op_threads, warmup_iterations] {
+            auto session = std::make_shared<YOLOv8Model>(model_path, config, 0.2f, 0.2f, intra_op_threads);
+            session->warmup(warmup_iterations);
+            return session;
+        }));
+    }
+    for (auto& init : session_init) {
+        sessions.push_back(init.get());
+    }
+    first_warmup.get();
+    auto rss_all = current_rss_bytes();
+    first_session_bytes = rss_first > rss_start ? rss_first - rss_start : 0;
+    if (num_sessions > 1 && rss_all > rss_first) {
+        additional_session_bytes = (rss_all - rss_first) / (num_sessions - 1);
+    }
+
+    // 2. Per-worker preprocessing/postprocessing state
+    for (int i = 0; i < num_workers; ++i) {
+        workspaces.push_back(std::make_unique<DetectionWorkspace>(*sessions[i % num_sessions], config));
+    }
+
+    pool = std::make_unique<WorkStealingPool>(num_workers);
+    logger.info("[DetectionServer][INFO] " + std::to_string(num_workers) + " workers, " +
+                std::to_string(num_sessions) + " sessions, " + std::to_string(intra_op_threads) + " intra-op threads each");
+    if (rss_start > 0) {
+        logger.info("[DetectionServer][INFO] Session RSS: first " + std::to_string(first_session_bytes / (1024 * 1024)) +
+                    " MB, each additional " + std::to_string(additional_session_bytes / (1024 * 1024)) + " MB");
+    }
+}
+
+void DetectionServer::add_stream(const std::string& name, std::unique_ptr<FrameSource> source,
+                                 const cv::Rect& region, int64_t max_frames) {
+    auto stream = std::make_unique<Stream>();
+    stream->name = name;
+    stream->source = std::move(source);
+    stream->region = region;
+    stream->max_frames = max_frames;
+    streams.push_back(std::move(stream));
+}
+
+void DetectionServer::process_next(Stream& stream, int worker_id) {
+    if (stream.max_frames >= 0 && stream.frames >= stream.max_frames) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!stream.source->grab(stream.region, stream.frame)) {
+        return;
+    }
+    detection_metrics().frames_in.add();
+    try {
+        auto& session = *sessions[worker_id % sessions.size()];
+        workspaces[worker_id]->detect(session, stream.frame.image, stream.detections);
+    } catch (const std::exception& e) {
+        logger.error("[DetectionServer][ERROR] Stream " + stream.name + " failed: " + std::string(e.what()));
+        return;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    stream.latencies_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    detection_metrics().detect_latency.observe_ms(stream.latencies_ms.back());
+    detection_metrics().frames_out.add();
+    ++stream.frames;
+
+    // Next frame of this stream lands on this worker's deque; idle workers steal it
+    pool->submit([this, &stream](int next_worker) { process_next(stream, next_worker); });
+}
+
+ServerReport DetectionServer::run() {
+    auto report = ServerReport();
+    auto start = std::chrono::steady_clock::now();
+    auto steals_before = pool->get_steal_count();
+
+    for (auto& stream : streams) {
+        auto* stream_ptr = stream.get();
+        pool->submit([this, stream_ptr](int worker_id) { process_next(*stream_ptr, worker_id); });
+    }
+    pool->wait_idle();
+
+    report.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.steals = pool->get_steal_count() - steals_before;
+    for (const auto& stream : streams) {
+        auto stream_report = StreamReport();
+        stream_report.name = stream->name;
+        stream_report.frames = stream->frames;
+        if (!stream->latencies_ms.empty()) {
+            stream_report.mean_ms = std::accumulate(stream->latencies_ms.begin(), stream->latencies_ms.end(), 0.0) /
+                                    stream->latencies_ms.size();
+            stream_report.p50_ms = percentile(stream->latencies_ms, 0.5);
+            stream_report.p99_ms = percentile(stream->latencies_ms, 0.99);
+            stream_report.max_ms = percentile(stream->latencies_ms, 1.0);
+        }
+        report.total_frames += stream->frames;
+        report.streams.push_back(stream_report);
+    }
+    report.throughput_fps = report.wall_seconds > 0 ? report.total_frames / report.wall_seconds : 0.0;
+    return report;
+}
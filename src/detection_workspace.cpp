@@ -0,0 +1,65 @@
+#include "detection_workspace.hpp"
+#include "metrics.hpp"
+#include "memory_tracker.hpp"
+
+DetectionWorkspace::DetectionWorkspace(const YOLOv8Model& model, ConfigManager& config)
+    : preprocessor(model.get_input_width(), model.get_input_height()),
+      postprocessor(model.get_conf_threshold(), model.get_iou_threshold(), model.get_input_width(), model.get_input_height()) {
+    preprocessor.set_resize_mode(YOLOv8Preprocessor::parse_resize_mode(config.get_string("Model", "resize_mode", "stretch")),
+                                 config.get_int("Model", "letterbox_pad_value", 114));
+    bound_model_id = model.get_instance_id();
+}
+
+void DetectionWorkspace::bind(const YOLOv8Model& model) {
+    preprocessor.set_input_size(model.get_input_width(), model.get_input_height());
+    postprocessor.set_input_size(model.get_input_width(), model.get_input_height());
+    postprocessor.set_thresholds(model.get_conf_threshold(), model.get_iou_threshold());
+    bound_model_id = model.get_instance_id();
+}
+
+void DetectionWorkspace::detect(YOLOv8Model& model, const cv::Mat& image, std::vector<Detection>& detections) {
+    auto start_time = std::chrono::steady_clock::now();
+    if (model.get_instance_id() != bound_model_id) {
+        bind(model);
+    }
+    
+    // 1-2. Preprocess and run inference (uint8 models normalize inside the graph)
+    auto outputs = InferenceOutput();
+    auto preprocess_end = start_time;
+    if (model.has_uint8_input()) {
+        auto preprocess_scope = StageScope(PipelineStage::Preprocess);
+        const auto& input_image = preprocessor.prepare_input_u8(image);
+        if (input_image.empty()) {
+            detections.clear();
+            return;
+        }
+        preprocess_end = std::chrono::steady_clock::now();
+        auto inference_scope = StageScope(PipelineStage::Inference);
+        outputs = model.run_inference(input_image);
+    } else {
+        auto preprocess_scope = StageScope(PipelineStage::Preprocess);
+        const auto& input_tensor = preprocessor.prepare_input(image);
+        if (input_tensor.empty()) {
+            detections.clear();
+            return;
+        }
+        preprocess_end = std::chrono::steady_clock::now();
+        auto inference_scope = StageScope(PipelineStage::Inference);
+        outputs = model.run_inference(input_tensor);
+    }
+    auto inference_end = std::chrono::steady_clock::now();
+    
+    // 3. Postprocess results (boxes mapped back through the letterbox)
+    auto postprocess_scope = StageScope(PipelineStage::Postprocess);
+    postprocessor.process_output(outputs, image.size(), preprocessor.get_letterbox_info(), detections);
+    auto postprocess_end = std::chrono::steady_clock::now();
+    
+    last_timings.preprocess_ms = std::chrono::duration<double, std::milli>(preprocess_end - start_time).count();
+    last_timings.inference_ms = std::chrono::duration<double, std::milli>(inference_end - preprocess_end).count();
+    last_timings.postprocess_ms = std::chrono::duration<double, std::milli>(postprocess_end - inference_end).count();
+    
+    auto& metrics = detection_metrics();
+    metrics.preprocess_latency.observe_ms(last_timings.preprocess_ms);
+    metrics.inference_latency.observe_ms(last_timings.inference_ms);
+    metrics.postprocess_latency.observe_ms(last_timings.postprocess_ms);
+}
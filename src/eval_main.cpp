@@ -0,0 +1,316 @@
+#include "logger.hpp"
+#include "config_manager.hpp"
+#include "yolov8_detector.hpp"
+#include "detection_evaluator.hpp"
+#include "work_stealing_pool.hpp"
+#include "cpu_dispatch.hpp"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <thread>
+
+namespace {
+
+struct EvalOptions {
+    std::string images;
+    std::string labels_dir;
+    std::string model_path;
+    std::string backend;
+    std::string resize_mode;
+    std::string tiling;
+    std::string cascade;
+    std::string csv_path;
+    std::string tag;
+    cv::Size input_size;
+    float conf_threshold = -1.0f;
+    float iou_threshold = -1.0f;
+    int workers = 0;
+    int intra_op_threads = 1;
+    int64_t limit = -1;
+};
+
+// Per-worker state: one detector (and model session) each, results merged at the end
+struct EvalWorker {
+    std::unique_ptr<YOLOv8> detector;
+    DetectionEvaluator evaluator;
+    std::vector<Detection> labels;
+    std::vector<double> latencies_ms;
+    DetectionTimings stage_totals;
+};
+
+void print_usage() {
+    std::cout << "Usage: dogai_eval <images> [options]\n"
+              << "  <images>             image directory (or one image) with YOLO-format labels\n"
+              << "  --labels <dir>       label directory (default: images/ -> labels/, else next to each image)\n"
+              << "  --model <path>       ONNX model (default: [Model] model_path)\n"
+              << "  --backend <name>     inference backend: onnxruntime, opencv (default: [Model] backend)\n"
+              << "  --workers <n>        parallel workers, one model session each (default: cores / intra-op threads)\n"
+              << "  --intra-op <n>       backend threads per session (default 1)\n"
+              << "  --conf <t>           confidence threshold (default: [Model] conf_threshold; 0.001 for COCO-style mAP)\n"
+              << "  --iou <t>            NMS IoU threshold (default: [Model] iou_threshold)\n"
+              << "  --input <w>x<h>      model input size (dynamic-shape models only)\n"
+              << "  --resize <mode>      stretch or letterbox (default: [Model] resize_mode)\n"
+              << "  --tiling on|off      override [Tiling] enabled\n"
+              << "  --cascade on|off     override [Cascade] enabled\n"
+              << "  --limit <n>          evaluate the first n images only\n"
+              << "  --tag <text>         configuration name for the summary row (default: derived from options)\n"
+              << "  --csv <path>         append the summary row to a CSV file (Pareto table)\n";
+}
+
+bool parse_on_off(const std::string& value, std::string& out) {
+    if (value != "on" && value != "off") return false;
+    out = value == "on" ? "true" : "false";
+    return true;
+}
+
+bool parse_options(int argc, char** argv, EvalOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        auto arg = std::string(argv[i]);
+        auto has_value = i + 1 < argc;
+        if (arg == "--labels" && has_value) {
+            options.labels_dir = argv[++i];
+        } else if (arg == "--model" && has_value) {
+            options.model_path = argv[++i];
+        } else if (arg == "--backend" && has_value) {
+            options.backend = argv[++i];
+        } else if (arg == "--workers" && has_value) {
+            options.workers = std::stoi(argv[++i]);
+        } else if (arg == "--intra-op" && has_value) {
+            options.intra_op_threads = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--conf" && has_value) {
+            options.conf_threshold = std::stof(argv[++i]);
+        } else if (arg == "--iou" && has_value) {
+            options.iou_threshold = std::stof(argv[++i]);
+        } else if (arg == "--input" && has_value) {
+            auto value = std::string(argv[++i]);
+            auto x = value.find('x');
+            if (x == std::string::npos) return false;
+            options.input_size = cv::Size(std::stoi(value.substr(0, x)), std::stoi(value.substr(x + 1)));
+        } else if (arg == "--resize" && has_value) {
+            options.resize_mode = argv[++i];
+            if (options.resize_mode != "stretch" && options.resize_mode != "letterbox") return false;
+        } else if (arg == "--tiling" && has_value) {
+            if (!parse_on_off(argv[++i], options.tiling)) return false;
+        } else if (arg == "--cascade" && has_value) {
+            if (!parse_on_off(argv[++i], options.cascade)) return false;
+        } else if (arg == "--limit" && has_value) {
+            options.limit = std::stoll(argv[++i]);
+        } else if (arg == "--tag" && has_value) {
+            options.tag = argv[++i];
+        } else if (arg == "--csv" && has_value) {
+            options.csv_path = argv[++i];
+        } else if (options.images.empty() && !arg.empty() && arg[0] != '-') {
+            options.images = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options.images.empty();
+}
+
+// Command-line overrides go into the shared config, so every worker's detector sees the same setup
+void apply_overrides(const EvalOptions& options, ConfigManager& config) {
+    if (!options.backend.empty()) config.set_string("Model", "backend", options.backend);
+    if (options.conf_threshold >= 0.0f) config.set_string("Model", "conf_threshold", std::to_string(options.conf_threshold));
+    if (options.iou_threshold >= 0.0f) config.set_string("Model", "iou_threshold", std::to_string(options.iou_threshold));
+    if (!options.input_size.empty()) {
+        config.set_string("Model", "input_width", std::to_string(options.input_size.width));
+        config.set_string("Model", "input_height", std::to_string(options.input_size.height));
+    }
+    if (!options.resize_mode.empty()) config.set_string("Model", "resize_mode", options.resize_mode);
+    if (!options.tiling.empty()) config.set_string("Tiling", "enabled", options.tiling);
+    if (!options.cascade.empty()) config.set_string("Cascade", "enabled", options.cascade);
+    config.set_string("Model", "intra_op_threads", std::to_string(options.intra_op_threads));
+    // Unrelated images: reusing a previous result would only hide misses
+    config.set_string("Capture", "enable_frame_skip", "false");
+}
+
+std::vector<std::string> list_images(const std::string& path) {
+    auto images = std::vector<std::string>();
+    auto is_image = [](const std::filesystem::path& p) {
+        auto ext = p.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp";
+    };
+    auto error = std::error_code();
+    if (std::filesystem::is_directory(path, error)) {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(path, error)) {
+            if (entry.is_regular_file() && is_image(entry.path())) {
+                images.push_back(entry.path().string());
+            }
+        }
+        std::sort(images.begin(), images.end());
+    } else if (is_image(path)) {
+        images.push_back(path);
+    }
+    return images;
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    auto index = static_cast<size_t>(p * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+}
+
+int main(int argc, char** argv) {
+    auto options = EvalOptions();
+    try {
+        if (!parse_options(argc, argv, options)) {
+            print_usage();
+            return 1;
+        }
+    } catch (const std::exception&) {
+        print_usage();
+        return 1;
+    }
+
+    auto config = ConfigManager("blood.cfg");
+    CpuDispatch::configure(config);
+    apply_overrides(options, config);
+    if (options.model_path.empty()) {
+        options.model_path = config.get_string("Model", "model_path", "models/blood.onnx");
+    }
+
+    auto images = list_images(options.images);
+    if (options.limit >= 0 && static_cast<int64_t>(images.size()) > options.limit) {
+        images.resize(options.limit);
+    }
+    if (images.empty()) {
+        logger.error("[EVAL][ERROR] No images found in " + options.images);
+        return 1;
+    }
+
+    try {
+        // 1. One detector per worker, created and warmed up in parallel
+        auto cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        auto num_workers = options.workers > 0 ? options.workers : std::max(1, cores / options.intra_op_threads);
+        num_workers = std::min<int>(num_workers, static_cast<int>(images.size()));
+        auto workers = std::vector<EvalWorker>(num_workers);
+        auto detector_init = std::vector<std::future<std::unique_ptr<YOLOv8>>>();
+        for (int i = 0; i < num_workers; ++i) {
+            detector_init.push_back(std::async(std::launch::async, [&options, &config] {
+                return std::make_unique<YOLOv8>(options.model_path, config);
+            }));
+        }
+        for (int i = 0; i < num_workers; ++i) {
+            workers[i].detector = detector_init[i].get();
+        }
+
+        // 2. Images are spread over the workers; decoding and label parsing stay outside the timed region
+        auto pool = WorkStealingPool(num_workers);
+        auto failures = std::atomic<int64_t>(0);
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& image_path : images) {
+            pool.submit([&, image_path](int worker_id) {
+                auto& worker = workers[worker_id];
+                try {
+                    auto image = cv::imread(image_path, cv::IMREAD_COLOR);
+                    if (image.empty() ||
+                        !DetectionEvaluator::load_yolo_labels(DetectionEvaluator::label_path_for(image_path, options.labels_dir),
+                                                              image.size(), worker.labels)) {
+                        logger.error("[EVAL][ERROR] Could not read " + image_path + " or its labels");
+                        failures.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                    auto detect_start = std::chrono::steady_clock::now();
+                    auto detections = worker.detector->detect_objects(image);
+                    worker.latencies_ms.push_back(
+                        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - detect_start).count());
+                    const auto& timings = worker.detector->get_last_timings();
+                    worker.stage_totals.preprocess_ms += timings.preprocess_ms;
+                    worker.stage_totals.inference_ms += timings.inference_ms;
+                    worker.stage_totals.postprocess_ms += timings.postprocess_ms;
+                    worker.evaluator.add_image(detections, worker.labels);
+                } catch (const std::exception& e) {
+                    logger.error("[EVAL][ERROR] " + image_path + ": " + std::string(e.what()));
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        pool.wait_idle();
+        auto wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // 3. Merge and report
+        auto evaluator = DetectionEvaluator();
+        auto latencies = std::vector<double>();
+        auto stage_totals = DetectionTimings();
+        for (const auto& worker : workers) {
+            evaluator.merge(worker.evaluator);
+            latencies.insert(latencies.end(), worker.latencies_ms.begin(), worker.latencies_ms.end());
+            stage_totals.preprocess_ms += worker.stage_totals.preprocess_ms;
+            stage_totals.inference_ms += worker.stage_totals.inference_ms;
+            stage_totals.postprocess_ms += worker.stage_totals.postprocess_ms;
+        }
+        auto report = evaluator.evaluate();
+        auto evaluated = static_cast<double>(std::max<size_t>(1, latencies.size()));
+        auto mean_ms = std::accumulate(latencies.begin(), latencies.end(), 0.0) / evaluated;
+        auto p50_ms = percentile(latencies, 0.5);
+        auto p99_ms = percentile(latencies, 0.99);
+        auto throughput = wall_seconds > 0 ? latencies.size() / wall_seconds : 0.0;
+
+        const auto& reference = *workers.front().detector;
+        auto input_width = config.get_int("Model", "input_width", 640);
+        auto input_height = config.get_int("Model", "input_height", 640);
+        auto resize_mode = config.get_string("Model", "resize_mode", "stretch");
+        auto tiling = reference.get_tiled_detector() ? "tiling" : "";
+        auto cascade = reference.get_cascade() ? "cascade" : "";
+        auto conf = config.get_float("Model", "conf_threshold", 0.3f);
+        auto tag = options.tag;
+        if (tag.empty()) {
+            tag = std::filesystem::path(options.model_path).stem().string() + "@" + std::to_string(input_width) + "x" +
+                  std::to_string(input_height) + "/" + resize_mode + "/" + reference.get_backend_name();
+            if (*tiling) tag += std::string("/") + tiling;
+            if (*cascade) tag += std::string("/") + cascade;
+        }
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << "[EVAL] Model: " << options.model_path << " | Backend: " << reference.get_backend_name()
+                  << " | Workers: " << num_workers << " x " << options.intra_op_threads << " intra-op threads"
+                  << " | CPU kernels: " << CpuDispatch::describe() << "\n"
+                  << "[EVAL] Images: " << report.images << " (" << failures.load() << " failed) | conf " << conf
+                  << " | IoU thresholds 0.50:0.05:0.95\n";
+        for (const auto& accuracy : report.classes) {
+            std::cout << "[EVAL] Class " << accuracy.class_id << ": " << accuracy.ground_truth << " labels | "
+                      << accuracy.predictions << " predictions | P " << accuracy.precision << " | R " << accuracy.recall
+                      << " | AP50 " << accuracy.ap50 << " | AP50-95 " << accuracy.ap50_95 << "\n";
+        }
+        std::cout << "[EVAL] mAP@0.5: " << report.map50 << " | mAP@0.5:0.95: " << report.map50_95 << "\n"
+                  << "[EVAL] Throughput: " << throughput << " images/s | latency ms mean " << mean_ms
+                  << " | p50 " << p50_ms << " | p99 " << p99_ms << "\n"
+                  << "[EVAL] Stages ms (mean): preprocess " << stage_totals.preprocess_ms / evaluated
+                  << " | inference " << stage_totals.inference_ms / evaluated
+                  << " | postprocess " << stage_totals.postprocess_ms / evaluated << "\n"
+                  << "[EVAL] Row: " << tag << "," << report.map50 << "," << report.map50_95 << "," << throughput << ","
+                  << mean_ms << "," << p99_ms << "\n";
+
+        // One row per run: concatenated runs form the accuracy/speed Pareto table
+        if (!options.csv_path.empty()) {
+            auto write_header = !std::filesystem::exists(options.csv_path);
+            auto csv = std::ofstream(options.csv_path, std::ios::app);
+            if (!csv) {
+                logger.error("[EVAL][ERROR] Could not open " + options.csv_path);
+                return 1;
+            }
+            if (write_header) {
+                csv << "config,map50,map50_95,images_per_s,mean_ms,p99_ms,images,workers,intra_op_threads,conf\n";
+            }
+            csv << std::fixed << std::setprecision(4) << tag << "," << report.map50 << "," << report.map50_95 << ","
+                << throughput << "," << mean_ms << "," << p99_ms << "," << report.images << "," << num_workers << ","
+                << options.intra_op_threads << "," << conf << "\n";
+        }
+    } catch (const std::exception& e) {
+        logger.error("[EVAL][ERROR] Exception captured: " + std::string(e.what()));
+        return 1;
+    }
+    return 0;
+}
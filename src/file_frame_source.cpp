@@ -0,0 +1,154 @@
+#include "file_frame_source.hpp"
+#include "raw_frame_container.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+FileFrameSource::FileFrameSource(const std::string& path, bool loop_frames, PixelFormat format)
+    : loop(loop_frames), output_format(format) {
+    auto paths = std::vector<std::string>();
+    if (is_image_file(path)) {
+        image_paths.push_back(path);
+    } else {
+        // Directory of images, or a video file when the glob finds nothing
+        try {
+            cv::glob(path, paths, false);
+        } catch (const cv::Exception&) {
+            paths.clear();
+        }
+        for (const auto& p : paths) {
+            if (is_image_file(p)) {
+                image_paths.push_back(p);
+            }
+        }
+        std::sort(image_paths.begin(), image_paths.end());
+    }
+
+    if (image_paths.empty()) {
+        is_video = video.open(path);
+        if (!is_video) {
+            logger.error("[FileFrameSource][ERROR] Could not open " + path);
+            return;
+        }
+        source_size = cv::Size(static_cast<int>(video.get(cv::CAP_PROP_FRAME_WIDTH)),
+                               static_cast<int>(video.get(cv::CAP_PROP_FRAME_HEIGHT)));
+    } else {
+        // Geometry of the first image defines the source size
+        auto first = cv::imread(image_paths[0], cv::IMREAD_COLOR);
+        if (first.empty()) {
+            logger.error("[FileFrameSource][ERROR] Could not decode " + image_paths[0]);
+            return;
+        }
+        source_size = first.size();
+    }
+    opened = true;
+}
+
+bool FileFrameSource::is_image_file(const std::string& path) {
+    auto dot = path.find_last_of('.');
+    if (dot == std::string::npos) return false;
+    auto ext = path.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == "png" || ext == "jpg" || ext == "jpeg" || ext == "bmp";
+}
+
+int64_t FileFrameSource::get_frame_count() const {
+    if (is_video) {
+        auto count = static_cast<int64_t>(video.get(cv::CAP_PROP_FRAME_COUNT));
+        return count > 0 ? count : -1;
+    }
+    return static_cast<int64_t>(image_paths.size());
+}
+
+bool FileFrameSource::seek(int64_t frame_index) {
+    if (!opened || frame_index < 0) {
+        return false;
+    }
+    if (is_video) {
+        auto count = get_frame_count();
+        if (count >= 0 && frame_index >= count) {
+            return false;
+        }
+        // Many codecs only seek to keyframes: a position that does not read back exactly is
+        // a failure, and the decoder goes back to where it was so callers can decode and drop
+        auto previous = video.get(cv::CAP_PROP_POS_FRAMES);
+        auto landed = video.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(frame_index)) &&
+                      std::llround(video.get(cv::CAP_PROP_POS_FRAMES)) == frame_index;
+        if (!landed) {
+            video.set(cv::CAP_PROP_POS_FRAMES, previous);
+            return false;
+        }
+    } else {
+        if (static_cast<size_t>(frame_index) >= image_paths.size()) {
+            return false;
+        }
+        next_image = static_cast<size_t>(frame_index);
+    }
+    frame_counter = frame_index;
+    return true;
+}
+
+bool FileFrameSource::decode_next(int64_t& timestamp_us) {
+    if (is_video) {
+        if (!video.read(decoded) && loop) {
+            video.set(cv::CAP_PROP_POS_FRAMES, 0);
+            video.read(decoded);
+        }
+        timestamp_us = static_cast<int64_t>(video.get(cv::CAP_PROP_POS_MSEC) * 1000.0);
+    } else {
+        if (next_image >= image_paths.size()) {
+            if (!loop) return false;
+            next_image = 0;
+        }
+        timestamp_us = now_us();
+        // A single image is decoded once and replayed
+        if (image_paths.size() == 1 && !current.empty()) {
+            ++next_image;
+            return true;
+        }
+        decoded = cv::imread(image_paths[next_image++], cv::IMREAD_COLOR);
+    }
+    if (decoded.empty()) {
+        return false;
+    }
+
+    if (output_format == PixelFormat::BGRA) {
+        cv::cvtColor(decoded, current, cv::COLOR_BGR2BGRA);
+    } else {
+        current = decoded;
+    }
+    source_size = current.size();
+    return true;
+}
+
+bool FileFrameSource::grab(const cv::Rect& region, Frame& frame) {
+    if (!opened) {
+        return false;
+    }
+    auto timestamp_us = int64_t(0);
+    if (!decode_next(timestamp_us)) {
+        return false;
+    }
+
+    auto roi = clamp_region(region);
+    if (roi.empty()) {
+        logger.error("[FileFrameSource][ERROR] Requested region is outside the frame");
+        return false;
+    }
+
+    // ROI view into the decoded frame, no copy
+    frame.image = current(roi);
+    frame.format = output_format;
+    frame.region = roi;
+    frame.frame_id = frame_counter++;
+    frame.timestamp_us = timestamp_us;
+    return true;
+}
+
+std::unique_ptr<FrameSource> open_file_frame_source(const std::string& path, bool loop_frames, PixelFormat format) {
+    // Raw containers replay in their recorded pixel format
+    if (RawFrameSource::is_raw_file(path)) {
+        return std::make_unique<RawFrameSource>(path, loop_frames);
+    }
+    return std::make_unique<FileFrameSource>(path, loop_frames, format);
+}
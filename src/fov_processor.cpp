@@ -15,21 +15,32 @@ cv::Size FOVProcessor::get_fov_size() const {
     return fov_size;
 }
 
-std::vector<Detection> FOVProcessor::process_fov_detections(const std::vector<Detection>& detections) {
-    auto processed_detections = detections;
+void FOVProcessor::compute_metrics(Span<const Detection> detections, std::vector<FovMetrics>& metrics) const {
+    auto count = detections.size();
+    metrics.resize(count);
+    auto inv_width = 1.0f / fov_width;
+    auto inv_height = 1.0f / fov_height;
     
-    // Calculate FOV metrics for each detection
-    for (auto& detection : processed_detections) {
-        calculate_fov_metrics(detection);
+    // 1. Centers and distances: straight-line arithmetic the compiler vectorizes
+    for (size_t i = 0; i < count; ++i) {
+        const auto& det = detections[i];
+        auto& m = metrics[i];
+        m.center.x = (det.x1 + det.x2) * 0.5f * inv_width;
+        m.center.y = (det.y1 + det.y2) * 0.5f * inv_height;
+        auto dx = m.center.x - 0.5f;  // Center of FOV is (0.5, 0.5)
+        auto dy = m.center.y - 0.5f;
+        m.distance = std::sqrt(dx * dx + dy * dy);
+    }
+    // 2. Angles (atan2 is a libm call, kept out of the loop above)
+    for (auto& m : metrics) {
+        m.angle = std::atan2(m.center.y - 0.5f, m.center.x - 0.5f);
     }
-    
-    return processed_detections;
 }
 
-cv::Point2f FOVProcessor::calculate_fov_center(const cv::Rect& box) const {
-    auto center = cv::Point2f();
-    center.x = (box.x + box.width / 2.0f) / fov_width;
-    center.y = (box.y + box.height / 2.0f) / fov_height;
+cv::Point2f FOVProcessor::calculate_fov_center(const Detection& detection) const {
+    auto center = detection.center();
+    center.x /= fov_width;
+    center.y /= fov_height;
     return center;
 }
 
@@ -47,8 +58,10 @@ float FOVProcessor::calculate_fov_angle(const cv::Point2f& center) const {
     return std::atan2(dy, dx);
 }
 
-void FOVProcessor::calculate_fov_metrics(Detection& detection) {
-    detection.fov_center = calculate_fov_center(detection.box);
-    detection.fov_distance = calculate_fov_distance(detection.fov_center);
-    detection.fov_angle = calculate_fov_angle(detection.fov_center);
-} 
\ No newline at end of file
+FovMetrics FOVProcessor::calculate_fov_metrics(const Detection& detection) const {
+    auto metrics = FovMetrics();
+    metrics.center = calculate_fov_center(detection);
+    metrics.distance = calculate_fov_distance(metrics.center);
+    metrics.angle = calculate_fov_angle(metrics.center);
+    return metrics;
+}
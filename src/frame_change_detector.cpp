@@ -0,0 +1,104 @@
+#include "frame_change_detector.hpp"
+#include "cpu_dispatch.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+FrameChangeDetector::FrameChangeDetector(const FrameChangeOptions& change_options) : options(change_options) {
+    options.grid = std::max(1, options.grid);
+    options.max_reuse_frames = std::max(0, options.max_reuse_frames);
+}
+
+FrameChangeOptions FrameChangeDetector::options_from_config(ConfigManager& config) {
+    auto result = FrameChangeOptions();
+    result.enabled = config.get_string("Capture", "enable_frame_skip", "false") == "true";
+    // frame_skip_ratio N: at most N - 1 reused frames between two detections
+    result.max_reuse_frames = std::max(0, config.get_int("Capture", "frame_skip_ratio", 2) - 1);
+    result.threshold = config.get_float("Capture", "frame_skip_threshold", result.threshold);
+    result.max_reuse_ms = config.get_int("Capture", "frame_skip_max_age_ms", result.max_reuse_ms);
+    result.grid = config.get_int("Capture", "frame_skip_grid", result.grid);
+    return result;
+}
+
+void FrameChangeDetector::build_geometry(const cv::Size& size, int channels) {
+    geometry_size = size;
+    geometry_channels = channels;
+    auto grid_cols = std::min(options.grid, size.width);
+    auto grid_rows = std::min(options.grid, size.height);
+
+    column_bounds.resize(grid_cols + 1);
+    for (int c = 0; c <= grid_cols; ++c) {
+        column_bounds[c] = (size.width * c / grid_cols) * channels;
+    }
+    row_block.resize(size.height);
+    for (int y = 0; y < size.height; ++y) {
+        row_block[y] = y * grid_rows / size.height;
+    }
+
+    max_block_delta.assign(static_cast<size_t>(grid_rows) * grid_cols, 0);
+    for (int r = 0; r < grid_rows; ++r) {
+        auto rows = (size.height * (r + 1) / grid_rows) - (size.height * r / grid_rows);
+        for (int c = 0; c < grid_cols; ++c) {
+            auto bytes = column_bounds[c + 1] - column_bounds[c];
+            max_block_delta[r * grid_cols + c] = static_cast<uint32_t>(options.threshold * rows * bytes);
+        }
+    }
+    current.assign(max_block_delta.size(), 0);
+    has_reference = false;
+}
+
+void FrameChangeDetector::compute_fingerprint(const cv::Mat& image) {
+    std::fill(current.begin(), current.end(), 0);
+    auto grid_cols = static_cast<int>(column_bounds.size()) - 1;
+    auto sum_bytes = CpuDispatch::kernels().sum_bytes;
+    for (int y = 0; y < image.rows; ++y) {
+        auto row = image.ptr<uint8_t>(y);
+        auto block = current.data() + static_cast<size_t>(row_block[y]) * grid_cols;
+        for (int c = 0; c < grid_cols; ++c) {
+            block[c] += sum_bytes(row + column_bounds[c], static_cast<size_t>(column_bounds[c + 1] - column_bounds[c]));
+        }
+    }
+}
+
+bool FrameChangeDetector::can_reuse(const cv::Mat& image) {
+    ++stats.frames;
+    current_valid = false;
+    if (image.empty() || image.depth() != CV_8U) {
+        return false;
+    }
+    if (image.size() != geometry_size || image.channels() != geometry_channels) {
+        build_geometry(image.size(), image.channels());
+    }
+    compute_fingerprint(image);
+    current_valid = true;
+    if (!has_reference) {
+        return false;
+    }
+
+    for (size_t i = 0; i < current.size(); ++i) {
+        auto delta = current[i] > reference[i] ? current[i] - reference[i] : reference[i] - current[i];
+        if (delta > max_block_delta[i]) {
+            ++stats.changed;
+            return false;
+        }
+    }
+
+    // Unchanged: still bounded by how many frames and how long one result may be reused
+    auto age_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - reference_time).count();
+    if (reuse_count >= options.max_reuse_frames || age_ms >= options.max_reuse_ms) {
+        ++stats.expired;
+        return false;
+    }
+    ++reuse_count;
+    ++stats.reused;
+    return true;
+}
+
+void FrameChangeDetector::commit() {
+    if (!current_valid) {
+        return;
+    }
+    reference = current;
+    has_reference = true;
+    reuse_count = 0;
+    reference_time = std::chrono::steady_clock::now();
+}
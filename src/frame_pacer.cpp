@@ -0,0 +1,129 @@
+#include "frame_pacer.hpp"
+#include "metrics.hpp"
+#include <algorithm>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+namespace {
+
+double to_ms(FramePacer::Clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+}
+
+FramePacer::FramePacer(const FramePacingOptions& pacing_options) : options(pacing_options) {
+    if (options.target_fps <= 0) {
+        options.mode = PacingMode::Unpaced;
+    }
+    options.spin_us = std::max(0, options.spin_us);
+    options.max_lag_frames = std::max(1, options.max_lag_frames);
+    if (is_paced()) {
+        period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options.target_fps));
+        spin = std::chrono::microseconds(options.spin_us);
+    }
+#ifdef _WIN32
+    // Plain Sleep rounds up to the 15.6 ms scheduler tick; the high-resolution timer
+    // (Windows 10 1803+) does not. Without it the spin stretch covers the difference.
+    if (is_paced()) {
+        timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!timer) {
+            spin = std::max<Clock::duration>(spin, std::chrono::milliseconds(2));
+        }
+    }
+#endif
+}
+
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+    if (timer) {
+        CloseHandle(timer);
+    }
+#endif
+}
+
+FramePacingOptions FramePacer::options_from_config(ConfigManager& config) {
+    auto result = FramePacingOptions();
+    result.target_fps = config.get_int("Performance", "target_fps", result.target_fps);
+    result.mode = config.get_string("Performance", "frame_pacing", "deadline") == "unpaced" ? PacingMode::Unpaced : PacingMode::Deadline;
+    result.spin_us = config.get_int("Performance", "pacing_spin_us", result.spin_us);
+    result.max_lag_frames = config.get_int("Performance", "pacing_max_lag_frames", result.max_lag_frames);
+    return result;
+}
+
+std::string FramePacer::describe_target() const {
+    return is_paced() ? std::to_string(options.target_fps) : std::string("unpaced");
+}
+
+bool FramePacer::wait() {
+    ++stats.frames;
+    if (!is_paced()) {
+        return true;
+    }
+
+    auto now = Clock::now();
+    if (!started) {
+        // First frame opens the schedule
+        deadline = now + period;
+        started = true;
+        return true;
+    }
+
+    // 1. Missed: keep the phase when slightly late (the next frame gets less slack),
+    //    restart from now when far behind instead of bursting frames to catch up
+    if (now >= deadline) {
+        auto late = now - deadline;
+        ++stats.missed;
+        stats.max_late_ms = std::max(stats.max_late_ms, to_ms(late));
+        detection_metrics().pacing_missed.add();
+        if (late > period * options.max_lag_frames) {
+            ++stats.resyncs;
+            deadline = now + period;
+        } else {
+            deadline += period;
+        }
+        return false;
+    }
+
+    // 2. Coarse sleep on the OS timer, then spin out the last stretch
+    auto wake = deadline - spin;
+    if (now < wake) {
+        sleep_until(wake);
+    }
+    auto spun = Clock::now();
+    while (spun < deadline) {
+        std::this_thread::yield();
+        spun = Clock::now();
+    }
+    stats.wait_ms_total += to_ms(spun - now);
+    stats.max_overshoot_ms = std::max(stats.max_overshoot_ms, to_ms(spun - deadline));
+    deadline += period;
+    return true;
+}
+
+void FramePacer::sleep_until(Clock::time_point wake) {
+#ifdef _WIN32
+    if (timer) {
+        // Relative due time, in 100 ns units
+        auto remaining = std::chrono::duration_cast<std::chrono::duration<LONGLONG, std::ratio<1, 10000000>>>(wake - Clock::now());
+        if (remaining.count() <= 0) {
+            return;
+        }
+        auto due = LARGE_INTEGER();
+        due.QuadPart = -remaining.count();
+        if (SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE)) {
+            WaitForSingleObject(timer, INFINITE);
+            return;
+        }
+    }
+#endif
+    std::this_thread::sleep_until(wake);
+}
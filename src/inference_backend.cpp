@@ -0,0 +1,15 @@
+#include "inference_backend.hpp"
+#include "onnxruntime_backend.hpp"
+#include "opencv_dnn_backend.hpp"
+#include <stdexcept>
+
+std::unique_ptr<InferenceBackend> create_inference_backend(const std::string& kind, const std::string& model_path,
+                                                           const BackendOptions& options) {
+    if (kind.empty() || kind == "onnxruntime" || kind == "ort") {
+        return std::make_unique<OnnxRuntimeBackend>(model_path, options);
+    }
+    if (kind == "opencv" || kind == "cv_dnn") {
+        return std::make_unique<OpenCvDnnBackend>(model_path, options);
+    }
+    throw std::runtime_error("Unknown inference backend '" + kind + "' (expected onnxruntime or opencv)");
+}
@@ -0,0 +1,4 @@
+#include "logger.hpp"
+
+// Global logger instance, shared by dogai_core and every executable
+Logger logger;
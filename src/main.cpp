@@ -5,19 +5,47 @@
 #include "yolov8_detector.hpp"
 #include "windows_graphics_capture.hpp"
 #include "config_manager.hpp"
+#include "render_stage.hpp"
+#include "annotated_video_writer.hpp"
+#include "result_ring.hpp"
+#include "metrics.hpp"
+#include "metrics_exporter.hpp"
+#include "memory_tracker.hpp"
+#include "cpu_dispatch.hpp"
+#include "startup_profile.hpp"
+#include "model_watcher.hpp"
+#include "frame_pacer.hpp"
 #include <opencv2/opencv.hpp>
 #include <iostream>
 #include <chrono>
 #include <thread>
 #include <atomic>
 #include <fstream>
-
-// Global logger instance
-Logger logger;
+#include <future>
 
 int main() {
+    auto startup = StartupProfile();
+    
+    // Load unified configuration, parsed once and shared by every component
+    auto step_start = StartupProfile::Clock::now();
+    auto config = ConfigManager("blood.cfg");
+    MemoryTracker::configure(config);
+    CpuDispatch::configure(config);
+    startup.record("config", step_start);
+    
+    // Initialize YOLOv8 model for Bloodstrike: session creation and warmup overlap the capture setup
+    auto model_path = std::string("models/blood.onnx");
+    auto detector_init = std::async(std::launch::async, [&config, &startup, model_path] {
+        auto start = StartupProfile::Clock::now();
+        auto detector = std::make_unique<YOLOv8>(model_path, config, 0.2f, 0.2f, &startup);
+        startup.record("detector", start);
+        return detector;
+    });
+    
     // Initialize Windows Graphics Capture
+    step_start = StartupProfile::Clock::now();
     WindowsGraphicsCapture capture;
+    startup.record("capture", step_start);
     if (!capture.is_initialized()) {
         logger.error("[MAIN][ERROR] Failed to initialize screen capture!");
         return -1;
@@ -29,20 +57,15 @@ int main() {
     logger.info("[MAIN][INFO] Screen size: " + std::to_string(screen_size.width) + "x" + std::to_string(screen_size.height));
     logger.info("[MAIN][INFO] Screen center: (" + std::to_string(screen_center.x) + ", " + std::to_string(screen_center.y) + ")");
     
-    // Load unified configuration
-    auto config = ConfigManager("blood.cfg");
-    
     // Check performance mode
     auto perf_mode = config.get_string("Performance", "performance_mode", "normal");
     if (perf_mode == "maximum") {
         logger.info("[MAIN][INFO] Maximum performance mode enabled - using ultra high FPS settings");
     }
     
-    // Initialize YOLOv8 model for Bloodstrike
-    auto model_path = "models/blood.onnx";
-    
     try {
-        auto yolov8_detector = YOLOv8(model_path, 0.2f, 0.2f);
+        auto detector = detector_init.get();
+        auto& yolov8_detector = *detector;
         
         // Configure FOV for Bloodstrike detection
         const int FOV_WIDTH = 400;
@@ -54,13 +77,47 @@ int main() {
                    std::to_string(screen_center.x - FOV_WIDTH/2) + ", " + 
                    std::to_string(screen_center.y - FOV_HEIGHT/2) + ")");
         
-        // Create windows for display
-        cv::namedWindow("Bloodstrike FOV Detection", cv::WINDOW_NORMAL);
-        cv::resizeWindow("Bloodstrike FOV Detection", FOV_WIDTH, FOV_HEIGHT);
+        // Only the FOV region is copied from the desktop, in its native BGRA layout
+        auto fov_region = capture.centered_region(FOV_WIDTH, FOV_HEIGHT);
+        auto captured = Frame();
         
-        // FPS Control Configuration
-        const int TARGET_FPS = config.get_int("Performance", "target_fps", 120);
-        const std::chrono::microseconds FRAME_TIME(1000000 / TARGET_FPS);
+        // Drawing and display run off the inference loop unless [Display] render_thread = false
+        auto render_thread = config.get_string("Display", "render_thread", "true") == "true";
+        auto render_stage = RenderStage("Bloodstrike FOV Detection", cv::Size(FOV_WIDTH, FOV_HEIGHT), render_thread);
+        
+        // Optional annotated recording ([Output]), encoded on its own thread
+        auto output_options = AnnotatedVideoWriter::options_from_config(config);
+        auto video_output = std::unique_ptr<AnnotatedVideoWriter>();
+        if (output_options.enabled) {
+            video_output = std::make_unique<AnnotatedVideoWriter>(output_options);
+        }
+        
+        // Optional Prometheus endpoint ([Metrics]), served from its own thread
+        auto metrics_exporter = std::unique_ptr<MetricsExporter>();
+        if (config.get_string("Metrics", "enabled", "false") == "true") {
+            metrics_exporter = std::make_unique<MetricsExporter>(config.get_string("Metrics", "listen", "127.0.0.1:9464"));
+        }
+        
+        // Optional shared-memory result ring for local consumers ([ResultRing])
+        auto result_ring = std::unique_ptr<ResultRingPublisher>();
+        if (config.get_string("ResultRing", "enabled", "false") == "true") {
+            result_ring = std::make_unique<ResultRingPublisher>(
+                config.get_string("ResultRing", "name", "dogai_results"),
+                static_cast<uint32_t>(config.get_int("ResultRing", "slots", 256)),
+                static_cast<uint32_t>(config.get_int("ResultRing", "max_detections", 64)));
+        }
+        
+        // Optional hot reload of retrained models ([Model] hot_reload), polled on its own thread
+        auto watch_options = ModelWatcher::options_from_config(config);
+        auto model_watcher = std::unique_ptr<ModelWatcher>();
+        if (watch_options.enabled) {
+            model_watcher = std::make_unique<ModelWatcher>(yolov8_detector, model_path, watch_options);
+        }
+        
+        // FPS Control Configuration: absolute frame deadlines, or unpaced for benchmarks
+        auto pacer = FramePacer(FramePacer::options_from_config(config));
+        const int TARGET_FPS = pacer.get_options().target_fps;
+        const auto TARGET_TEXT = pacer.describe_target();
         
         int frame_count = 0;
         auto last_frame_time = std::chrono::high_resolution_clock::now();
@@ -72,13 +129,14 @@ int main() {
         auto average_fps = 0.0;
         auto fps_measurement_interval = config.get_int("Performance", "fps_measurement_interval", 60);
         auto enable_fps_logging = config.get_string("Performance", "enable_fps_logging", "true") == "true";
+        auto fps_text = "FPS: 0 | Avg: 0 | Target: " + TARGET_TEXT;
+        auto memory_report = MemoryReport();
         
-        logger.info("[MAIN][INFO] Target FPS: " + std::to_string(TARGET_FPS));
+        logger.info("[MAIN][INFO] Target FPS: " + TARGET_TEXT);
         logger.info("[MAIN][INFO] FPS measurement enabled - logging every " + std::to_string(fps_measurement_interval) + " frames");
         logger.info("[MAIN][INFO] FPS will be displayed on screen and in logs");
         
         while (true) {
-            auto frame_start_time = std::chrono::high_resolution_clock::now();
             frame_count++;
             
             // Log first frame to show FPS measurement is active
@@ -87,31 +145,33 @@ int main() {
             }
             
             // Capture FOV region (400x400 centered on screen)
-            auto fov_frame = capture.capture_fov(FOV_WIDTH, FOV_HEIGHT);
-            
-            if (fov_frame.empty()) {
+            auto grabbed = false;
+            {
+                auto capture_scope = StageScope(PipelineStage::Capture);
+                grabbed = capture.grab(fov_region, captured);
+            }
+            if (!grabbed) {
                 logger.error("[MAIN][ERROR] Failed to capture FOV!");
+                detection_metrics().capture_failures.add();
                 continue;
             }
+            const auto& fov_frame = captured.image;
             
             // Detect objects in FOV
             auto fov_detections = yolov8_detector.detect_objects_fov(fov_frame);
+            memory_report.on_frame();
+            if (frame_count == 1) {
+                logger.info("[MAIN][INFO] Startup: " + startup.format() + " to first detection");
+            }
+            if (result_ring) {
+                result_ring->publish(captured.frame_id, captured.timestamp_us, fov_detections);
+            }
             
-            // Draw FOV detections with crosshair and metrics
-            auto fov_result = yolov8_detector.draw_fov_detections(fov_frame, fov_detections);
-            
-            // Add FPS text to the image
-            auto display_image = fov_result.clone();
-            auto fps_text = "FPS: " + std::to_string(static_cast<int>(current_fps)) + 
-                                  " | Avg: " + std::to_string(static_cast<int>(average_fps)) + 
-                                  " | Target: " + std::to_string(TARGET_FPS);
-            
-            // Draw FPS text on image
-            cv::putText(display_image, fps_text, cv::Point(10, 30), 
-                       cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(0, 255, 0), 2);
-            
-            // Show FOV detection with FPS
-            cv::imshow("Bloodstrike FOV Detection", display_image);
+            // Draw FOV detections with crosshair, metrics and FPS text, then show them
+            render_stage.submit(fov_frame, fov_detections, fps_text);
+            if (video_output) {
+                video_output->submit(fov_frame, fov_detections.detections, captured.timestamp_us);
+            }
             
             // Display detection info
             if (!fov_detections.empty()) {
@@ -119,12 +179,13 @@ int main() {
                           " - Detected " + std::to_string(fov_detections.size()) + " objects in FOV");
                 
                 for (size_t i = 0; i < fov_detections.size(); ++i) {
-                    const auto& det = fov_detections[i];
+                    const auto& det = fov_detections.detections[i];
+                    const auto& fov = fov_detections.fov[i];
                     logger.info("[MAIN][INFO] Detection " + std::to_string(i) + 
                               " - Class: " + std::to_string(det.class_id) + 
                               " - Score: " + std::to_string(det.score) +
-                              " - Distance: " + std::to_string(det.fov_distance) +
-                              " - Angle: " + std::to_string(det.fov_angle * 180 / 3.14159f) + "°");
+                              " - Distance: " + std::to_string(fov.distance) +
+                              " - Angle: " + std::to_string(fov.angle * 180 / 3.14159f) + "°");
                 }
             }
             
@@ -147,35 +208,50 @@ int main() {
                         average_fps += fps;
                     }
                     average_fps /= fps_history.size();
+                    fps_text = "FPS: " + std::to_string(static_cast<int>(current_fps)) + 
+                               " | Avg: " + std::to_string(static_cast<int>(average_fps)) + 
+                               " | Target: " + TARGET_TEXT;
                     
                     // Log detailed FPS information if enabled
                     if (enable_fps_logging) {
                         logger.info("[MAIN][FPS] Frame: " + std::to_string(frame_count) + 
                                   " | Current: " + std::to_string(static_cast<int>(current_fps)) + 
                                   " | Average: " + std::to_string(static_cast<int>(average_fps)) + 
-                                  " | Target: " + std::to_string(TARGET_FPS) +
+                                  " | Target: " + TARGET_TEXT +
                                   " | Elapsed: " + std::to_string(elapsed.count()) + "ms");
+                        if (pacer.is_paced()) {
+                            const auto& pacing = pacer.get_stats();
+                            logger.info("[MAIN][FPS] Missed deadlines: " + std::to_string(pacing.missed) +
+                                      " / " + std::to_string(pacing.frames) +
+                                      " | Worst late: " + std::to_string(pacing.max_late_ms) + "ms" +
+                                      " | Worst wake-up overshoot: " + std::to_string(pacing.max_overshoot_ms) + "ms");
+                        }
+                        if (auto change = yolov8_detector.get_change_detector()) {
+                            logger.info("[MAIN][FPS] Reused frames: " + std::to_string(change->get_stats().reused) +
+                                      " / " + std::to_string(change->get_stats().frames));
+                        }
                     } else {
                         // Always log basic FPS info
                         logger.info("[MAIN][FPS] Current: " + std::to_string(static_cast<int>(current_fps)) + 
                                   " | Average: " + std::to_string(static_cast<int>(average_fps)));
                     }
                     
+                    // Allocation tracking ([Debug] enable_memory_tracking)
+                    auto memory_line = memory_report.take();
+                    if (!memory_line.empty()) {
+                        logger.info(memory_line);
+                        logger.info("[MemoryTracker][INFO] Backend arena: " + yolov8_detector.get_arena_stats());
+                    }
+                    
                     fps_start_time = current_time;
                 }
             }
             
-            // FPS Control - Sleep if we're running too fast
-            auto frame_end_time = std::chrono::high_resolution_clock::now();
-            auto frame_duration = std::chrono::duration_cast<std::chrono::microseconds>(frame_end_time - frame_start_time);
-            
-            if (frame_duration < FRAME_TIME) {
-                auto sleep_time = FRAME_TIME - frame_duration;
-                std::this_thread::sleep_for(sleep_time);
-            }
+            // FPS Control - wait for this frame's deadline (window events are pumped by the render stage)
+            pacer.wait();
             
             // Press 'q' to stop
-            if (cv::waitKey(1) == 'q') {
+            if (render_stage.quit_requested()) {
                 break;
             }
         }
@@ -185,7 +261,11 @@ int main() {
             logger.info("[MAIN][FINAL] ===== FPS STATISTICS =====");
             logger.info("[MAIN][FINAL] Total frames processed: " + std::to_string(frame_count));
             logger.info("[MAIN][FINAL] Final average FPS: " + std::to_string(static_cast<int>(average_fps)));
-            logger.info("[MAIN][FINAL] Target FPS: " + std::to_string(TARGET_FPS));
+            logger.info("[MAIN][FINAL] Target FPS: " + TARGET_TEXT);
+            if (pacer.is_paced()) {
+                logger.info("[MAIN][FINAL] Missed deadlines: " + std::to_string(pacer.get_stats().missed) +
+                          " (" + std::to_string(pacer.get_stats().resyncs) + " schedule restarts)");
+            }
             
             // Calculate min/max FPS
             auto min_fps = *std::min_element(fps_history.begin(), fps_history.end());
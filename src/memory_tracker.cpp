@@ -0,0 +1,141 @@
+#include "memory_tracker.hpp"
+#include "process_memory.hpp"
+#include <cstdio>
+
+namespace {
+
+constexpr size_t NUM_STAGES = static_cast<size_t>(PipelineStage::Count);
+
+struct AtomicStageCounters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> mat_allocations{0};
+    std::atomic<uint64_t> mat_bytes{0};
+};
+
+// Plain globals: the hooks may run before any constructor
+AtomicStageCounters stage_counters[NUM_STAGES];
+thread_local PipelineStage current = PipelineStage::Other;
+
+// Wraps the standard cv::Mat allocator, counting new buffers for the current stage
+class TrackingMatAllocator : public cv::MatAllocator {
+private:
+    cv::MatAllocator* inner;
+
+public:
+    explicit TrackingMatAllocator(cv::MatAllocator* std_allocator) : inner(std_allocator) {}
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usage_flags) const override {
+        auto u = inner->allocate(dims, sizes, type, data, step, flags, usage_flags);
+        // User-provided buffers (ROI wraps, mapped frames) are not allocations
+        if (u && !data) {
+            MemoryTracker::record_mat_allocation(u->size);
+        }
+        return u;
+    }
+
+    bool allocate(cv::UMatData* data, cv::AccessFlag access_flags, cv::UMatUsageFlags usage_flags) const override {
+        return inner->allocate(data, access_flags, usage_flags);
+    }
+
+    void deallocate(cv::UMatData* data) const override {
+        inner->deallocate(data);
+    }
+};
+
+}
+
+std::atomic<bool> MemoryTracker::enabled{false};
+
+const char* pipeline_stage_name(PipelineStage stage) {
+    switch (stage) {
+        case PipelineStage::Capture: return "capture";
+        case PipelineStage::Gate: return "gate";
+        case PipelineStage::Preprocess: return "preprocess";
+        case PipelineStage::Inference: return "inference";
+        case PipelineStage::Postprocess: return "postprocess";
+        case PipelineStage::Render: return "render";
+        case PipelineStage::Output: return "output";
+        default: return "other";
+    }
+}
+
+void MemoryTracker::configure(ConfigManager& config) {
+    if (config.get_string("Debug", "enable_memory_tracking", "false") == "true") {
+        enable();
+    }
+}
+
+void MemoryTracker::enable() {
+    if (enabled.exchange(true)) {
+        return;
+    }
+    // Installed once and never removed: Mats allocated through it may outlive any scope
+    static auto mat_allocator = TrackingMatAllocator(cv::Mat::getStdAllocator());
+    cv::Mat::setDefaultAllocator(&mat_allocator);
+}
+
+void MemoryTracker::record_allocation(size_t size) {
+    auto& counters = stage_counters[static_cast<size_t>(current)];
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void MemoryTracker::record_mat_allocation(size_t size) {
+    auto& counters = stage_counters[static_cast<size_t>(current)];
+    counters.mat_allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.mat_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+PipelineStage MemoryTracker::current_stage() {
+    return current;
+}
+
+void MemoryTracker::set_current_stage(PipelineStage stage) {
+    current = stage;
+}
+
+void MemoryTracker::snapshot(Snapshot& out) {
+    for (size_t i = 0; i < NUM_STAGES; ++i) {
+        out[i].allocations = stage_counters[i].allocations.load(std::memory_order_relaxed);
+        out[i].bytes = stage_counters[i].bytes.load(std::memory_order_relaxed);
+        out[i].mat_allocations = stage_counters[i].mat_allocations.load(std::memory_order_relaxed);
+        out[i].mat_bytes = stage_counters[i].mat_bytes.load(std::memory_order_relaxed);
+    }
+}
+
+std::string MemoryTracker::format_report(const Snapshot& previous, const Snapshot& current_snapshot, uint64_t frames) {
+    auto per_frame = frames > 0 ? 1.0 / frames : 0.0;
+    auto report = std::string("[MemoryTracker][INFO] Per frame (" + std::to_string(frames) + " frames):");
+    char line[160];
+    for (size_t i = 0; i < NUM_STAGES; ++i) {
+        const auto& before = previous[i];
+        const auto& after = current_snapshot[i];
+        auto allocations = after.allocations - before.allocations;
+        auto mat_allocations = after.mat_allocations - before.mat_allocations;
+        if (allocations == 0 && mat_allocations == 0) {
+            continue;
+        }
+        std::snprintf(line, sizeof(line), " | %s %.1f allocs %.1f KB, %.2f Mats %.1f KB",
+                      pipeline_stage_name(static_cast<PipelineStage>(i)),
+                      allocations * per_frame, (after.bytes - before.bytes) * per_frame / 1024.0,
+                      mat_allocations * per_frame, (after.mat_bytes - before.mat_bytes) * per_frame / 1024.0);
+        report += line;
+    }
+    std::snprintf(line, sizeof(line), " | peak RSS %.1f MB", peak_rss_bytes() / (1024.0 * 1024.0));
+    report += line;
+    return report;
+}
+
+std::string MemoryReport::take() {
+    if (!MemoryTracker::is_enabled() || frames == 0) {
+        return std::string();
+    }
+    auto current = MemoryTracker::Snapshot();
+    MemoryTracker::snapshot(current);
+    auto report = MemoryTracker::format_report(previous, current, frames);
+    previous = current;
+    frames = 0;
+    return report;
+}
@@ -0,0 +1,53 @@
+#include "metrics.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double FIRST_BUCKET_US = 10.0;
+constexpr double BUCKET_GROWTH = 1.25;
+
+}
+
+DetectionMetrics& detection_metrics() {
+    static DetectionMetrics metrics;
+    return metrics;
+}
+
+void LatencySummary::observe_ms(double ms) {
+    auto us = std::max(0.0, ms * 1000.0);
+    auto index = us <= FIRST_BUCKET_US ? 0 : static_cast<int>(std::ceil(std::log(us / FIRST_BUCKET_US) / std::log(BUCKET_GROWTH)));
+    index = std::min(index, NUM_BUCKETS - 1);
+    buckets[index].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum_us.fetch_add(static_cast<uint64_t>(us), std::memory_order_relaxed);
+}
+
+void LatencySummary::snapshot(Snapshot& out) const {
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        out[i] = buckets[i].load(std::memory_order_relaxed);
+    }
+}
+
+double LatencySummary::bucket_upper_seconds(int index) {
+    return FIRST_BUCKET_US * std::pow(BUCKET_GROWTH, index) / 1e6;
+}
+
+double LatencySummary::quantile_seconds(const Snapshot& previous, const Snapshot& current, double q) {
+    auto total = uint64_t(0);
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        total += current[i] - previous[i];
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+    auto target = static_cast<uint64_t>(std::ceil(q * total));
+    auto seen = uint64_t(0);
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        seen += current[i] - previous[i];
+        if (seen >= std::max<uint64_t>(1, target)) {
+            return bucket_upper_seconds(i);
+        }
+    }
+    return bucket_upper_seconds(NUM_BUCKETS - 1);
+}
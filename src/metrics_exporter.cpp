@@ -0,0 +1,269 @@
+#include "metrics_exporter.hpp"
+#include "process_memory.hpp"
+#include "memory_tracker.hpp"
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using socket_length = int;
+#define close_fd closesocket
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using socket_length = socklen_t;
+#define close_fd ::close
+#endif
+
+namespace {
+
+struct SummaryEntry {
+    const char* stage;
+    const LatencySummary* summary;
+};
+
+std::vector<SummaryEntry> stage_summaries(const DetectionMetrics& m) {
+    return {
+        {"detect", &m.detect_latency},
+        {"preprocess", &m.preprocess_latency},
+        {"inference", &m.inference_latency},
+        {"postprocess", &m.postprocess_latency},
+        {"gate", &m.gate_latency},
+        {"ort_run", &m.ort_run_latency},
+    };
+}
+
+void write_counter(std::ostringstream& out, const char* name, const char* help, uint64_t value) {
+    out << "# HELP " << name << " " << help << "\n# TYPE " << name << " counter\n" << name << " " << value << "\n";
+}
+
+void write_gauge(std::ostringstream& out, const char* name, const char* help, double value) {
+    out << "# HELP " << name << " " << help << "\n# TYPE " << name << " gauge\n" << name << " " << value << "\n";
+}
+
+}
+
+MetricsExporter::MetricsExporter(const std::string& address) : listen_address(address) {
+#ifdef _WIN32
+    auto wsa = WSADATA();
+    WSAStartup(MAKEWORD(2, 2), &wsa);
+#endif
+    if (!open_socket()) {
+        logger.error("[MetricsExporter][ERROR] Could not listen on " + listen_address);
+        return;
+    }
+    server_thread = std::thread(&MetricsExporter::serve_loop, this);
+    logger.info("[MetricsExporter][INFO] Serving Prometheus metrics on " + listen_address);
+}
+
+MetricsExporter::~MetricsExporter() {
+    stopping.store(true);
+    if (server_thread.joinable()) {
+        server_thread.join();
+    }
+    close_socket();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+bool MetricsExporter::open_socket() {
+#ifndef _WIN32
+    if (listen_address.rfind("unix:", 0) == 0) {
+        unix_path = listen_address.substr(5);
+        auto address = sockaddr_un();
+        if (unix_path.empty() || unix_path.size() >= sizeof(address.sun_path)) {
+            return false;
+        }
+        auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, unix_path.c_str(), sizeof(address.sun_path) - 1);
+        ::unlink(unix_path.c_str());
+        if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 4) != 0) {
+            close_fd(fd);
+            unix_path.clear();
+            return false;
+        }
+        listen_socket = fd;
+        return true;
+    }
+#endif
+
+    // host:port, loopback only unless another address is given explicitly
+    auto colon = listen_address.rfind(':');
+    auto host = colon == std::string::npos ? std::string("127.0.0.1") : listen_address.substr(0, colon);
+    auto port = colon == std::string::npos ? listen_address : listen_address.substr(colon + 1);
+    auto address = sockaddr_in();
+    address.sin_family = AF_INET;
+    try {
+        address.sin_port = htons(static_cast<uint16_t>(std::stoi(port)));
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+        return false;
+    }
+    auto fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd == static_cast<decltype(fd)>(-1)) {
+        return false;
+    }
+    auto reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 4) != 0) {
+        close_fd(fd);
+        return false;
+    }
+    listen_socket = static_cast<intptr_t>(fd);
+    return true;
+}
+
+void MetricsExporter::close_socket() {
+    if (listen_socket != -1) {
+        close_fd(listen_socket);
+        listen_socket = -1;
+    }
+#ifndef _WIN32
+    if (!unix_path.empty()) {
+        ::unlink(unix_path.c_str());
+        unix_path.clear();
+    }
+#endif
+}
+
+void MetricsExporter::serve_loop() {
+    while (!stopping.load()) {
+        // Wake up regularly to notice shutdown
+        auto readable = fd_set();
+        FD_ZERO(&readable);
+        FD_SET(listen_socket, &readable);
+        auto timeout = timeval();
+        timeout.tv_sec = 0;
+        timeout.tv_usec = 200000;
+        if (select(static_cast<int>(listen_socket + 1), &readable, nullptr, nullptr, &timeout) <= 0) {
+            continue;
+        }
+        auto client = accept(listen_socket, nullptr, nullptr);
+        if (client == static_cast<decltype(client)>(-1)) {
+            continue;
+        }
+
+        // A client that connects and stays silent (or stops reading) must not hang the
+        // thread, and with it shutdown: 200 ms for the request, then for each send
+        FD_ZERO(&readable);
+        FD_SET(client, &readable);
+        timeout.tv_sec = 0;
+        timeout.tv_usec = 200000;
+        if (select(static_cast<int>(client + 1), &readable, nullptr, nullptr, &timeout) <= 0) {
+            close_fd(client);
+            continue;
+        }
+#ifdef _WIN32
+        auto send_timeout = DWORD(200);
+#else
+        auto send_timeout = timeval();
+        send_timeout.tv_usec = 200000;
+#endif
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&send_timeout), sizeof(send_timeout));
+
+        // Any request gets the metrics page; the request itself is only drained
+        char request[2048];
+        recv(client, request, sizeof(request), 0);
+        auto body = render();
+        auto response = std::string("HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: ") +
+                        std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        auto sent = size_t(0);
+        while (sent < response.size()) {
+            auto n = send(client, response.data() + sent, static_cast<int>(response.size() - sent), 0);
+            if (n <= 0) break;
+            sent += static_cast<size_t>(n);
+        }
+        close_fd(client);
+    }
+}
+
+std::string MetricsExporter::render() {
+    const auto& m = detection_metrics();
+    auto out = std::ostringstream();
+
+    // 1. Frames
+    write_counter(out, "dogai_frames_in_total", "Frames submitted to detection.", m.frames_in.get());
+    write_counter(out, "dogai_frames_out_total", "Frames with a finished detection.", m.frames_out.get());
+    write_counter(out, "dogai_frames_reused_total", "Frames answered by the unchanged-frame early-out.", m.frames_reused.get());
+    write_counter(out, "dogai_frames_gated_total", "Frames answered by the cascade gate alone.", m.frames_gated.get());
+    out << "# HELP dogai_frames_dropped_total Frames lost before or after detection.\n"
+        << "# TYPE dogai_frames_dropped_total counter\n"
+        << "dogai_frames_dropped_total{reason=\"capture\"} " << m.capture_failures.get() << "\n"
+        << "dogai_frames_dropped_total{reason=\"output\"} " << m.output_dropped.get() << "\n"
+        << "dogai_frames_dropped_total{reason=\"render\"} " << m.render_dropped.get() << "\n";
+    write_counter(out, "dogai_model_swaps_total", "Replacement models published by hot swap.", m.model_swaps.get());
+    write_counter(out, "dogai_model_swap_failures_total", "Replacement models that failed to load.", m.model_swap_failures.get());
+    write_counter(out, "dogai_pacing_missed_deadlines_total", "Frames that finished past their pacing deadline.", m.pacing_missed.get());
+
+    // 2. Latency summaries (quantiles over the last scrape interval)
+    auto summaries = stage_summaries(m);
+    previous_snapshots.resize(summaries.size(), LatencySummary::Snapshot{});
+    out << "# HELP dogai_stage_latency_seconds Per-stage latency; quantiles cover the interval since the last scrape.\n"
+        << "# TYPE dogai_stage_latency_seconds summary\n";
+    for (size_t i = 0; i < summaries.size(); ++i) {
+        auto current = LatencySummary::Snapshot();
+        summaries[i].summary->snapshot(current);
+        for (auto q : {0.5, 0.9, 0.99}) {
+            out << "dogai_stage_latency_seconds{stage=\"" << summaries[i].stage << "\",quantile=\"" << q << "\"} "
+                << LatencySummary::quantile_seconds(previous_snapshots[i], current, q) << "\n";
+        }
+        out << "dogai_stage_latency_seconds_sum{stage=\"" << summaries[i].stage << "\"} " << summaries[i].summary->get_sum_seconds() << "\n"
+            << "dogai_stage_latency_seconds_count{stage=\"" << summaries[i].stage << "\"} " << summaries[i].summary->get_count() << "\n";
+        previous_snapshots[i] = current;
+    }
+
+    // 3. Queues
+    out << "# HELP dogai_queue_depth Items waiting in pipeline queues.\n# TYPE dogai_queue_depth gauge\n"
+        << "dogai_queue_depth{queue=\"async\"} " << m.async_in_flight.get() << "\n"
+        << "dogai_queue_depth{queue=\"output\"} " << m.output_queue_depth.get() << "\n";
+
+    // 4. Memory (allocation counters only run with [Debug] enable_memory_tracking)
+    write_gauge(out, "dogai_resident_memory_bytes", "Resident set size.", static_cast<double>(current_rss_bytes()));
+    write_gauge(out, "dogai_peak_resident_memory_bytes", "Peak resident set size.", static_cast<double>(peak_rss_bytes()));
+
+    // 5. Allocations, overall and per stage
+    if (MemoryTracker::is_enabled()) {
+        auto allocations = allocation_count();
+        auto frames = m.frames_out.get();
+        auto per_frame = frames > previous_frames
+            ? static_cast<double>(allocations - previous_allocations) / (frames - previous_frames) : 0.0;
+        previous_allocations = allocations;
+        previous_frames = frames;
+        write_counter(out, "dogai_allocations_total", "Heap allocations through operator new.", allocations);
+        write_counter(out, "dogai_allocated_bytes_total", "Bytes requested through operator new.", allocated_bytes());
+        write_gauge(out, "dogai_allocations_per_frame", "Allocations per finished frame since the last scrape (whole process).", per_frame);
+
+        auto stages = MemoryTracker::Snapshot();
+        MemoryTracker::snapshot(stages);
+        out << "# HELP dogai_stage_allocations_total Allocations attributed to a pipeline stage.\n"
+            << "# TYPE dogai_stage_allocations_total counter\n";
+        for (size_t i = 0; i < stages.size(); ++i) {
+            auto stage = pipeline_stage_name(static_cast<PipelineStage>(i));
+            out << "dogai_stage_allocations_total{stage=\"" << stage << "\",kind=\"new\"} " << stages[i].allocations << "\n"
+                << "dogai_stage_allocations_total{stage=\"" << stage << "\",kind=\"mat\"} " << stages[i].mat_allocations << "\n";
+        }
+        out << "# HELP dogai_stage_allocated_bytes_total Bytes allocated by a pipeline stage.\n"
+            << "# TYPE dogai_stage_allocated_bytes_total counter\n";
+        for (size_t i = 0; i < stages.size(); ++i) {
+            auto stage = pipeline_stage_name(static_cast<PipelineStage>(i));
+            out << "dogai_stage_allocated_bytes_total{stage=\"" << stage << "\",kind=\"new\"} " << stages[i].bytes << "\n"
+                << "dogai_stage_allocated_bytes_total{stage=\"" << stage << "\",kind=\"mat\"} " << stages[i].mat_bytes << "\n";
+        }
+    }
+    return out.str();
+}
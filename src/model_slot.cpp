@@ -0,0 +1,14 @@
+#include "model_slot.hpp"
+
+ModelSlot::ModelSlot(std::shared_ptr<YOLOv8Model> model) : current(std::move(model)) {
+}
+
+std::shared_ptr<YOLOv8Model> ModelSlot::acquire() const {
+    return std::atomic_load_explicit(&current, std::memory_order_acquire);
+}
+
+std::shared_ptr<YOLOv8Model> ModelSlot::exchange(std::shared_ptr<YOLOv8Model> model) {
+    auto previous = std::atomic_exchange_explicit(&current, std::move(model), std::memory_order_acq_rel);
+    generation.fetch_add(1, std::memory_order_acq_rel);
+    return previous;
+}
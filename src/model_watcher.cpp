@@ -0,0 +1,78 @@
+#include "model_watcher.hpp"
+#include <algorithm>
+
+ModelWatcher::ModelWatcher(YOLOv8& watched_detector, const std::string& current_model_path, const ModelWatchOptions& watch_options)
+    : detector(watched_detector), options(watch_options), model_path(current_model_path) {
+    options.interval_ms = std::max(50, options.interval_ms);
+    modification_time(model_path, model_time);
+    watch_thread = std::thread(&ModelWatcher::watch_loop, this);
+    logger.info("[ModelWatcher][INFO] Watching " + model_path + " and " + options.config_path + " every " +
+                std::to_string(options.interval_ms) + " ms");
+}
+
+ModelWatcher::~ModelWatcher() {
+    {
+        auto lock = std::lock_guard<std::mutex>(stop_mutex);
+        stopping = true;
+    }
+    stop_signal.notify_all();
+    if (watch_thread.joinable()) {
+        watch_thread.join();
+    }
+}
+
+ModelWatchOptions ModelWatcher::options_from_config(ConfigManager& config) {
+    auto result = ModelWatchOptions();
+    result.enabled = config.get_string("Model", "hot_reload", "false") == "true";
+    result.interval_ms = config.get_int("Model", "hot_reload_interval_ms", result.interval_ms);
+    return result;
+}
+
+bool ModelWatcher::modification_time(const std::string& path, std::filesystem::file_time_type& time) {
+    auto error = std::error_code();
+    auto result = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    time = result;
+    return true;
+}
+
+void ModelWatcher::watch_loop() {
+    auto lock = std::unique_lock<std::mutex>(stop_mutex);
+    while (!stop_signal.wait_for(lock, std::chrono::milliseconds(options.interval_ms), [this] { return stopping; })) {
+        lock.unlock();
+        try {
+            poll();
+        } catch (const std::exception& e) {
+            logger.warning("[ModelWatcher][WARNING] Poll failed: " + std::string(e.what()));
+        }
+        lock.lock();
+    }
+}
+
+void ModelWatcher::poll() {
+    // 1. Which model should be serving, and is it a different file (or a rewritten one)?
+    auto config = ConfigManager(options.config_path);
+    auto path = config.get_string("Model", "model_path", model_path);
+    auto time = std::filesystem::file_time_type();
+    if (!modification_time(path, time)) {
+        return;
+    }
+    if (path == model_path && time == model_time) {
+        candidate_path.clear();
+        return;
+    }
+
+    // 2. Wait until the file stops changing: a model still being copied in would fail to parse
+    if (path != candidate_path || time != candidate_time) {
+        candidate_path = path;
+        candidate_time = time;
+        return;
+    }
+    if (detector.request_model_swap(path)) {
+        model_path = path;
+        model_time = time;
+        candidate_path.clear();
+    }
+}
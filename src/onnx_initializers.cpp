@@ -0,0 +1,207 @@
+#include "onnx_initializers.hpp"
+
+namespace {
+
+// Protobuf wire format: varint keys (field << 3 | wire type) followed by the value
+enum WireType { VARINT = 0, FIXED64 = 1, LENGTH_DELIMITED = 2, FIXED32 = 5 };
+
+// Field numbers from onnx.proto
+constexpr uint32_t MODEL_GRAPH = 7;
+constexpr uint32_t GRAPH_INITIALIZER = 5;
+constexpr uint32_t TENSOR_DIMS = 1;
+constexpr uint32_t TENSOR_DATA_TYPE = 2;
+constexpr uint32_t TENSOR_NAME = 8;
+constexpr uint32_t TENSOR_RAW_DATA = 9;
+constexpr uint32_t TENSOR_EXTERNAL_DATA = 13;
+constexpr uint32_t TENSOR_DATA_LOCATION = 14;
+
+class Reader {
+private:
+    const uint8_t* cursor;
+    const uint8_t* end;
+
+public:
+    Reader(const uint8_t* data, size_t size) : cursor(data), end(data + size) {}
+
+    bool at_end() const { return cursor == end; }
+
+    bool varint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+            auto byte = *cursor++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool key(uint32_t& field, uint32_t& wire_type) {
+        auto value = uint64_t(0);
+        if (!varint(value)) {
+            return false;
+        }
+        field = static_cast<uint32_t>(value >> 3);
+        wire_type = static_cast<uint32_t>(value & 7);
+        return true;
+    }
+
+    bool bytes(const uint8_t*& data, size_t& size) {
+        auto length = uint64_t(0);
+        if (!varint(length) || length > static_cast<uint64_t>(end - cursor)) {
+            return false;
+        }
+        data = cursor;
+        size = static_cast<size_t>(length);
+        cursor += size;
+        return true;
+    }
+
+    bool skip(uint32_t wire_type) {
+        auto value = uint64_t(0);
+        const uint8_t* data = nullptr;
+        auto size = size_t(0);
+        switch (wire_type) {
+            case VARINT: return varint(value);
+            case LENGTH_DELIMITED: return bytes(data, size);
+            case FIXED64: return advance(8);
+            case FIXED32: return advance(4);
+            default: return false;     // Groups are not used by onnx.proto
+        }
+    }
+
+private:
+    bool advance(size_t count) {
+        if (count > static_cast<size_t>(end - cursor)) {
+            return false;
+        }
+        cursor += count;
+        return true;
+    }
+};
+
+// False only for malformed input; `keep` says whether the tensor has usable raw data
+bool read_tensor(const uint8_t* data, size_t size, OnnxInitializer& tensor, bool& keep) {
+    auto reader = Reader(data, size);
+    auto external = false;
+    auto has_raw_data = false;
+    while (!reader.at_end()) {
+        auto field = uint32_t(0), wire_type = uint32_t(0);
+        if (!reader.key(field, wire_type)) {
+            return false;
+        }
+        auto value = uint64_t(0);
+        const uint8_t* bytes = nullptr;
+        auto length = size_t(0);
+        if (field == TENSOR_DIMS && wire_type == VARINT) {
+            if (!reader.varint(value)) return false;
+            tensor.dims.push_back(static_cast<int64_t>(value));
+        } else if (field == TENSOR_DIMS && wire_type == LENGTH_DELIMITED) {
+            // Packed repeated int64
+            if (!reader.bytes(bytes, length)) return false;
+            auto packed = Reader(bytes, length);
+            while (!packed.at_end()) {
+                if (!packed.varint(value)) return false;
+                tensor.dims.push_back(static_cast<int64_t>(value));
+            }
+        } else if (field == TENSOR_DATA_TYPE && wire_type == VARINT) {
+            if (!reader.varint(value)) return false;
+            tensor.data_type = static_cast<int32_t>(value);
+        } else if (field == TENSOR_NAME && wire_type == LENGTH_DELIMITED) {
+            if (!reader.bytes(bytes, length)) return false;
+            tensor.name.assign(reinterpret_cast<const char*>(bytes), length);
+        } else if (field == TENSOR_RAW_DATA && wire_type == LENGTH_DELIMITED) {
+            if (!reader.bytes(tensor.data, tensor.size)) return false;
+            has_raw_data = true;
+        } else if (field == TENSOR_DATA_LOCATION && wire_type == VARINT) {
+            if (!reader.varint(value)) return false;
+            external = external || value != 0;
+        } else {
+            external = external || field == TENSOR_EXTERNAL_DATA;
+            if (!reader.skip(wire_type)) return false;
+        }
+    }
+
+    // raw_data must hold exactly the elements the shape describes
+    auto element_size = onnx_element_size(tensor.data_type);
+    auto expected = element_size;
+    for (auto dim : tensor.dims) {
+        if (dim < 0 || (dim > 0 && expected > SIZE_MAX / static_cast<uint64_t>(dim))) {
+            expected = 0;
+            break;
+        }
+        expected *= static_cast<size_t>(dim);
+    }
+    keep = has_raw_data && !external && !tensor.name.empty() && element_size > 0 && expected == tensor.size;
+    return true;
+}
+
+bool read_graph(const uint8_t* data, size_t size, std::vector<OnnxInitializer>& initializers) {
+    auto reader = Reader(data, size);
+    while (!reader.at_end()) {
+        auto field = uint32_t(0), wire_type = uint32_t(0);
+        if (!reader.key(field, wire_type)) {
+            return false;
+        }
+        if (field != GRAPH_INITIALIZER || wire_type != LENGTH_DELIMITED) {
+            if (!reader.skip(wire_type)) return false;
+            continue;
+        }
+        const uint8_t* bytes = nullptr;
+        auto length = size_t(0);
+        auto tensor = OnnxInitializer();
+        auto keep = false;
+        if (!reader.bytes(bytes, length) || !read_tensor(bytes, length, tensor, keep)) {
+            return false;
+        }
+        if (keep) {
+            initializers.push_back(std::move(tensor));
+        }
+    }
+    return true;
+}
+
+}
+
+bool read_onnx_initializers(const uint8_t* data, size_t size, std::vector<OnnxInitializer>& initializers) {
+    initializers.clear();
+    auto reader = Reader(data, size);
+    auto found_graph = false;
+    while (!reader.at_end()) {
+        auto field = uint32_t(0), wire_type = uint32_t(0);
+        if (!reader.key(field, wire_type)) {
+            return false;
+        }
+        if (field != MODEL_GRAPH || wire_type != LENGTH_DELIMITED) {
+            if (!reader.skip(wire_type)) return false;
+            continue;
+        }
+        const uint8_t* bytes = nullptr;
+        auto length = size_t(0);
+        if (!reader.bytes(bytes, length) || !read_graph(bytes, length, initializers)) {
+            return false;
+        }
+        found_graph = true;
+    }
+    return found_graph;
+}
+
+size_t onnx_element_size(int32_t data_type) {
+    switch (data_type) {
+        case 1: return 4;      // FLOAT
+        case 2: return 1;      // UINT8
+        case 3: return 1;      // INT8
+        case 4: return 2;      // UINT16
+        case 5: return 2;      // INT16
+        case 6: return 4;      // INT32
+        case 7: return 8;      // INT64
+        case 9: return 1;      // BOOL
+        case 10: return 2;     // FLOAT16
+        case 11: return 8;     // DOUBLE
+        case 12: return 4;     // UINT32
+        case 13: return 8;     // UINT64
+        case 16: return 2;     // BFLOAT16
+        default: return 0;     // STRING, complex and sub-byte types are not shared
+    }
+}
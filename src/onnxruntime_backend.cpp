@@ -0,0 +1,331 @@
+#include "onnxruntime_backend.hpp"
+#include "metrics.hpp"
+#include "mapped_file.hpp"
+#include "onnx_initializers.hpp"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+// Shapes and scalars feed shape inference and constant folding and weigh nothing: not shared
+constexpr size_t MIN_SHARED_INITIALIZER_BYTES = 1024;
+// Same alignment as ORT's CPU allocator
+constexpr size_t INITIALIZER_ALIGNMENT = 64;
+
+}
+
+OnnxRuntimeEnvironment::OnnxRuntimeEnvironment(const SessionMemoryOptions& options)
+    : env(ORT_LOGGING_LEVEL_WARNING, "YOLOv8") {
+    if (!options.shared_arena) {
+        return;
+    }
+    // Sessions opt in with session.use_env_allocators; without it each keeps a private arena
+    try {
+        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        auto arena = Ort::ArenaCfg(options.arena_max_bytes, options.arena_extend_strategy,
+                                   options.arena_initial_chunk_bytes, -1);
+        env.CreateAndRegisterAllocator(memory_info, arena);
+        arena_registered = true;
+        logger.info("[OnnxRuntimeEnvironment][INFO] Shared CPU arena registered (" +
+                    std::string(options.arena_extend_strategy == 1 ? "same_as_requested" : "next_power_of_two") +
+                    (options.arena_max_bytes > 0 ? ", cap " + std::to_string(options.arena_max_bytes / (1024 * 1024)) + " MB" : std::string()) + ")");
+    } catch (const std::exception& e) {
+        logger.warning("[OnnxRuntimeEnvironment][WARNING] Shared arena unavailable, sessions keep their own: " + std::string(e.what()));
+    }
+}
+
+std::shared_ptr<OnnxRuntimeEnvironment> OnnxRuntimeEnvironment::acquire(const SessionMemoryOptions& options) {
+    static auto instance_mutex = std::mutex();
+    static auto instance = std::weak_ptr<OnnxRuntimeEnvironment>();
+    auto lock = std::lock_guard<std::mutex>(instance_mutex);
+    auto environment = instance.lock();
+    if (!environment) {
+        environment = std::make_shared<OnnxRuntimeEnvironment>(options);
+        instance = environment;
+    }
+    return environment;
+}
+
+std::shared_ptr<SharedModelWeights> OnnxRuntimeEnvironment::weights_for(const std::string& model_path,
+                                                                      const uint8_t* model_data, size_t model_size) {
+    // A rewritten file (hot reload of the same path) must not pick up the old weights
+    auto error = std::error_code();
+    auto key = model_path + "|" + std::to_string(std::filesystem::file_size(model_path, error));
+    key += "|" + std::to_string(std::filesystem::last_write_time(model_path, error).time_since_epoch().count());
+
+    auto lock = std::lock_guard<std::mutex>(weights_mutex);
+    auto& entry = weights[key];
+    auto shared = entry.lock();
+    if (!shared) {
+        shared = std::make_shared<SharedModelWeights>();
+        if (model_data) {
+            load_initializers(*shared, model_path, model_data, model_size);
+        }
+        entry = shared;
+    }
+    // Drop entries of models no session uses anymore
+    for (auto it = weights.begin(); it != weights.end();) {
+        it = it->second.expired() ? weights.erase(it) : std::next(it);
+    }
+    return shared;
+}
+
+void OnnxRuntimeEnvironment::load_initializers(SharedModelWeights& shared, const std::string& model_path,
+                                               const uint8_t* model_data, size_t model_size) {
+    auto parsed = std::vector<OnnxInitializer>();
+    if (!read_onnx_initializers(model_data, model_size, parsed)) {
+        logger.warning("[OnnxRuntimeEnvironment][WARNING] Could not read the initializers of " + model_path +
+                       ", each session loads its own");
+        return;
+    }
+
+    // One copy in memory we own rather than views over the mapping: a hot-reload rollout
+    // may rewrite or truncate the file in place while sessions still use it
+    auto total = size_t(0);
+    for (const auto& tensor : parsed) {
+        if (tensor.size >= MIN_SHARED_INITIALIZER_BYTES) {
+            total += (tensor.size + INITIALIZER_ALIGNMENT - 1) / INITIALIZER_ALIGNMENT * INITIALIZER_ALIGNMENT;
+        }
+    }
+    if (total == 0) {
+        return;
+    }
+    shared.storage.resize(total + INITIALIZER_ALIGNMENT);
+    auto base = reinterpret_cast<uintptr_t>(shared.storage.data());
+    auto* cursor = shared.storage.data() + (INITIALIZER_ALIGNMENT - base % INITIALIZER_ALIGNMENT) % INITIALIZER_ALIGNMENT;
+
+    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    for (const auto& tensor : parsed) {
+        if (tensor.size < MIN_SHARED_INITIALIZER_BYTES) {
+            continue;
+        }
+        std::memcpy(cursor, tensor.data, tensor.size);
+        shared.initializers.push_back(Ort::Value::CreateTensor(memory_info, cursor, tensor.size, tensor.dims.data(), tensor.dims.size(),
+                                                               static_cast<ONNXTensorElementDataType>(tensor.data_type)));
+        shared.initializer_names.push_back(tensor.name);
+        shared.initializer_bytes += tensor.size;
+        cursor += (tensor.size + INITIALIZER_ALIGNMENT - 1) / INITIALIZER_ALIGNMENT * INITIALIZER_ALIGNMENT;
+    }
+    logger.info("[OnnxRuntimeEnvironment][INFO] Sharing " + std::to_string(shared.initializers.size()) + " initializers (" +
+                std::to_string(shared.initializer_bytes / 1024) + " KB) of " + model_path);
+}
+
+OnnxRuntimeBackend::OnnxRuntimeBackend(const std::string& model_path, const BackendOptions& options)
+    : width(options.input_width), height(options.input_height) {
+    initialize(model_path, options);
+}
+
+void OnnxRuntimeBackend::initialize(const std::string& model_path, const BackendOptions& options) {
+    try {
+        environment = OnnxRuntimeEnvironment::acquire(options.memory);
+        auto& env = environment->get_env();
+        
+        // CPU Optimization for AMD RX 7600 XT
+        // Using CPU with maximum optimizations for high FPS
+        // Sessions shared by several workers use fewer threads each
+        auto session_options = Ort::SessionOptions();
+        session_options.SetIntraOpNumThreads(options.intra_op_threads); // Use more CPU threads
+        session_options.SetInterOpNumThreads(4); // Parallel execution
+        // Layout optimizations (NCHWc) are faster on x86 but reorder conv weights into a new
+        // per-session copy, which initializer sharing cannot avoid
+        session_options.SetGraphOptimizationLevel(options.memory.layout_optimization ? GraphOptimizationLevel::ORT_ENABLE_ALL
+                                                                                      : GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+        
+        // [Memory] sharing: one arena for the process (weights are attached once the model is mapped)
+        if (options.memory.shared_arena && environment->has_shared_arena()) {
+            session_options.AddConfigEntry("session.use_env_allocators", "1");
+        }
+        
+        logger.info("[OnnxRuntimeBackend][INFO] CPU optimization enabled for high FPS");
+        logger.info("[OnnxRuntimeBackend][INFO] Using " + std::to_string(options.intra_op_threads) + " threads for maximum performance");
+        
+        // Map the model and hand ORT the bytes: no read() copy through the ORT file loader.
+        // ORT parses the buffer during construction, so the mapping is released right after.
+        auto load_start = std::chrono::steady_clock::now();
+        auto model_file = MappedFile();
+        auto mapped = model_file.open(model_path);
+        if (options.memory.share_weights) {
+            shared_weights = environment->weights_for(model_path, mapped ? model_file.data() : nullptr, model_file.size());
+            if (!shared_weights->initializers.empty()) {
+                session_options.AddExternalInitializers(shared_weights->initializer_names, shared_weights->initializers);
+            }
+        }
+        if (mapped) {
+            session = shared_weights
+                ? Ort::Session(env, model_file.data(), model_file.size(), session_options, shared_weights->prepacked)
+                : Ort::Session(env, model_file.data(), model_file.size(), session_options);
+        } else {
+            logger.warning("[OnnxRuntimeBackend][WARNING] Could not map " + model_path + ", letting ONNX Runtime open it");
+#ifdef _WIN32
+            auto wmodel_path = std::wstring(model_path.begin(), model_path.end());
+            session = shared_weights ? Ort::Session(env, wmodel_path.c_str(), session_options, shared_weights->prepacked)
+                                     : Ort::Session(env, wmodel_path.c_str(), session_options);
+#else
+            session = shared_weights ? Ort::Session(env, model_path.c_str(), session_options, shared_weights->prepacked)
+                                     : Ort::Session(env, model_path.c_str(), session_options);
+#endif
+        }
+        auto load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+        logger.info("[OnnxRuntimeBackend][INFO] Session for " + model_path + " (" + std::to_string(model_file.size() / 1024) +
+                    " KB) created in " + std::to_string(static_cast<int>(load_ms)) + " ms" +
+                    (shared_weights ? ", shared weights (" + std::to_string(shared_weights->initializer_bytes / 1024) + " KB of initializers)" : std::string()) +
+                    (options.memory.shared_arena && environment->has_shared_arena() ? ", shared arena" : ""));
+        model_file.close();
+        
+        auto allocator = Ort::AllocatorWithDefaultOptions();
+        
+        // Get output names
+        auto num_outputs = session.GetOutputCount();
+        for (size_t i = 0; i < num_outputs; ++i) {
+            auto output_name_alloc = session.GetOutputNameAllocated(i, allocator);
+            output_names.push_back(output_name_alloc.get());
+        }
+        
+        // Input names and detailed input of the model (equal to Python)
+        auto num_inputs = session.GetInputCount();
+        for (size_t i = 0; i < num_inputs; ++i) {
+            auto input_name_alloc = session.GetInputNameAllocated(i, allocator);
+            auto input_name = input_name_alloc.get();
+            input_names.push_back(input_name);
+            
+            auto type_info = session.GetInputTypeInfo(i);
+            auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+            auto type = tensor_info.GetElementType();
+            auto input_dims = tensor_info.GetShape();
+            
+            auto type_str = std::string();
+            switch (type) {
+                case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: type_str = "float32"; break;
+                case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: type_str = "uint8"; break;
+                case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8: type_str = "int8"; break;
+                default: type_str = "unknown"; break;
+            }
+            
+            auto dims_str = std::string();
+            for (size_t j = 0; j < input_dims.size(); ++j) {
+                dims_str += std::to_string(input_dims[j]);
+                if (j + 1 < input_dims.size()) dims_str += ", ";
+            }
+            
+            if (i == 0) {
+                element_type = type;
+                logger.info("[OnnxRuntimeBackend][INFO] Input " + std::string(input_name) + ": " + type_str + " [" + dims_str + "]");
+                
+                // uint8 models (see tools/prepare_uint8_input.py) take raw BGR pixels as [1, H, W, 3]
+                if (type == ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8) {
+                    if (input_dims.size() != 4 || input_dims[3] != 3) {
+                        throw std::runtime_error("uint8 model input must be NHWC [1, H, W, 3]");
+                    }
+                    if (input_dims[1] > 0 && input_dims[2] > 0) {
+                        height = static_cast<int>(input_dims[1]);
+                        width = static_cast<int>(input_dims[2]);
+                    }
+                    logger.info("[OnnxRuntimeBackend][INFO] uint8 HWC input detected - normalization runs inside the graph");
+                } else if (input_dims.size() == 4 && input_dims[2] > 0 && input_dims[3] > 0 &&
+                           (input_dims[2] != height || input_dims[3] != width)) {
+                    // Static NCHW shape wins over [Model] input_width/height (e.g. small cascade gate models)
+                    height = static_cast<int>(input_dims[2]);
+                    width = static_cast<int>(input_dims[3]);
+                    logger.info("[OnnxRuntimeBackend][INFO] Input size taken from model: " + std::to_string(width) + "x" + std::to_string(height));
+                }
+            }
+        }
+        
+        if (input_names.empty() || output_names.empty()) {
+            throw std::runtime_error("Model has no inputs or outputs");
+        }
+        for (const auto& input_name : input_names) input_names_char.push_back(input_name.c_str());
+        for (const auto& output_name : output_names) output_names_char.push_back(output_name.c_str());
+        
+    } catch (const std::exception& e) {
+        logger.error("[OnnxRuntimeBackend][ERROR] Failed to initialize model: " + std::string(e.what()));
+        throw;
+    }
+}
+
+TensorElementType OnnxRuntimeBackend::input_type() const {
+    return element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8 ? TensorElementType::UInt8 : TensorElementType::Float32;
+}
+
+InferenceOutput OnnxRuntimeBackend::run(const std::vector<float>& input_tensor) {
+    if (element_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+        logger.error("[OnnxRuntimeBackend][ERROR] Model expects uint8 HWC input, got float tensor");
+        throw std::runtime_error("Model expects uint8 HWC input");
+    }
+    auto input_shape = std::vector<int64_t>{1, 3, height, width};
+    auto input = Ort::Value::CreateTensor<float>(
+        Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault),
+        const_cast<float*>(input_tensor.data()),
+        input_tensor.size(),
+        input_shape.data(),
+        input_shape.size());
+    return run_session(input);
+}
+
+InferenceOutput OnnxRuntimeBackend::run(const cv::Mat& input_image) {
+    if (element_type != ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8) {
+        logger.error("[OnnxRuntimeBackend][ERROR] Model expects float NCHW input, got uint8 image");
+        throw std::runtime_error("Model expects float NCHW input");
+    }
+    // Wrap the pixels directly, no float conversion on the host
+    auto input_shape = std::vector<int64_t>{1, height, width, 3};
+    auto input = Ort::Value::CreateTensor<uint8_t>(
+        Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault),
+        const_cast<uint8_t*>(input_image.ptr<uint8_t>()),
+        input_image.total() * 3,
+        input_shape.data(),
+        input_shape.size());
+    return run_session(input);
+}
+
+InferenceOutput OnnxRuntimeBackend::run_session(const Ort::Value& input) {
+    try {
+        auto run_start = std::chrono::steady_clock::now();
+        auto values = std::make_shared<std::vector<Ort::Value>>(session.Run(
+            Ort::RunOptions{nullptr}, input_names_char.data(), &input, 1, output_names_char.data(), output_names_char.size()));
+        detection_metrics().ort_run_latency.observe_ms(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - run_start).count());
+        
+        // Float views over the ORT-owned output buffers
+        auto result = InferenceOutput();
+        for (const auto& value : *values) {
+            auto view = TensorView();
+            view.shape = value.GetTensorTypeAndShapeInfo().GetShape();
+            view.data = value.GetTensorData<float>();
+            result.tensors.push_back(std::move(view));
+        }
+        result.storage = std::move(values);
+        return result;
+    } catch (const std::exception& e) {
+        logger.error("[OnnxRuntimeBackend][ERROR] Failed to execute inference: " + std::string(e.what()));
+        throw;
+    }
+}
+
+std::string OnnxRuntimeBackend::get_arena_stats() {
+    auto result = std::string();
+#if ORT_API_VERSION >= 22
+    try {
+        const auto& api = Ort::GetApi();
+        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        auto allocator = Ort::Allocator(session, memory_info);
+        OrtKeyValuePairs* stats = nullptr;
+        if (auto status = api.AllocatorGetStats(allocator, &stats)) {
+            api.ReleaseStatus(status);
+            return result;
+        }
+        const char* const* keys = nullptr;
+        const char* const* values = nullptr;
+        auto count = size_t(0);
+        api.GetKeyValuePairs(stats, &keys, &values, &count);
+        for (size_t i = 0; i < count; ++i) {
+            if (!result.empty()) result += " ";
+            result += std::string(keys[i]) + "=" + values[i];
+        }
+        api.ReleaseKeyValuePairs(stats);
+    } catch (const std::exception& e) {
+        logger.warning("[OnnxRuntimeBackend][WARNING] Arena statistics unavailable: " + std::string(e.what()));
+    }
+#endif
+    return result;
+}
@@ -0,0 +1,76 @@
+#include "opencv_dnn_backend.hpp"
+#include "metrics.hpp"
+#include "mapped_file.hpp"
+#include <chrono>
+
+OpenCvDnnBackend::OpenCvDnnBackend(const std::string& model_path, const BackendOptions& options)
+    : width(options.input_width), height(options.input_height) {
+    try {
+        // Parse from the mapped bytes like the ORT backend; the Net copies the weights it keeps
+        auto load_start = std::chrono::steady_clock::now();
+        auto model_file = MappedFile();
+        if (model_file.open(model_path)) {
+            net = cv::dnn::readNetFromONNX(reinterpret_cast<const char*>(model_file.data()), model_file.size());
+        } else {
+            logger.warning("[OpenCvDnnBackend][WARNING] Could not map " + model_path + ", letting OpenCV open it");
+            net = cv::dnn::readNetFromONNX(model_path);
+        }
+        if (net.empty()) {
+            throw std::runtime_error("OpenCV could not parse " + model_path);
+        }
+        net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+        net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+        output_names = net.getUnconnectedOutLayersNames();
+
+        auto load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+        logger.info("[OpenCvDnnBackend][INFO] Net for " + model_path + " (" + std::to_string(model_file.size() / 1024) +
+                    " KB) loaded in " + std::to_string(static_cast<int>(load_ms)) + " ms");
+        // cv::dnn exposes no input shape before the first forward: [Model] input size is authoritative
+        logger.info("[OpenCvDnnBackend][INFO] Input size from config: " + std::to_string(width) + "x" + std::to_string(height) +
+                    ", " + std::to_string(output_names.size()) + " output(s)");
+    } catch (const std::exception& e) {
+        logger.error("[OpenCvDnnBackend][ERROR] Failed to initialize model: " + std::string(e.what()));
+        throw;
+    }
+}
+
+InferenceOutput OpenCvDnnBackend::run(const std::vector<float>& input_tensor) {
+    // Wrap the preprocessed tensor as a [1, 3, H, W] blob, no copy
+    const int blob_shape[] = {1, 3, height, width};
+    auto blob = cv::Mat(4, blob_shape, CV_32F, const_cast<float*>(input_tensor.data()));
+
+    try {
+        auto outputs = std::make_shared<std::vector<cv::Mat>>();
+        {
+            auto lock = std::lock_guard<std::mutex>(run_mutex);
+            auto run_start = std::chrono::steady_clock::now();
+            net.setInput(blob);
+            net.forward(*outputs, output_names);
+            // Output blobs are reused by the next forward: take ownership before unlocking
+            for (auto& output : *outputs) {
+                output = output.clone();
+            }
+            detection_metrics().ort_run_latency.observe_ms(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - run_start).count());
+        }
+
+        auto result = InferenceOutput();
+        for (const auto& output : *outputs) {
+            auto view = TensorView();
+            for (int i = 0; i < output.dims; ++i) {
+                view.shape.push_back(output.size[i]);
+            }
+            view.data = output.ptr<float>();
+            result.tensors.push_back(std::move(view));
+        }
+        result.storage = std::move(outputs);
+        return result;
+    } catch (const std::exception& e) {
+        logger.error("[OpenCvDnnBackend][ERROR] Failed to execute inference: " + std::string(e.what()));
+        throw;
+    }
+}
+
+InferenceOutput OpenCvDnnBackend::run(const cv::Mat&) {
+    logger.error("[OpenCvDnnBackend][ERROR] uint8 HWC models are not supported by the OpenCV backend");
+    throw std::runtime_error("OpenCV backend expects float NCHW input");
+}
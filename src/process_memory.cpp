@@ -0,0 +1,138 @@
+#include "process_memory.hpp"
+#include "memory_tracker.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+std::atomic<uint64_t> allocation_bytes{0};
+
+void* counted_alloc(std::size_t size) {
+    // Shared counters are only touched with tracking on: disabled, the hook is one relaxed load
+    if (MemoryTracker::is_enabled()) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+        MemoryTracker::record_allocation(size);
+    }
+    if (auto p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+}
+
+uint64_t allocation_count() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t allocated_bytes() {
+    return allocation_bytes.load(std::memory_order_relaxed);
+}
+
+#ifdef _WIN32
+
+size_t current_rss_bytes() {
+    auto counters = PROCESS_MEMORY_COUNTERS();
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return static_cast<size_t>(counters.WorkingSetSize);
+}
+
+size_t peak_rss_bytes() {
+    auto counters = PROCESS_MEMORY_COUNTERS();
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return static_cast<size_t>(counters.PeakWorkingSetSize);
+}
+
+#else
+
+size_t current_rss_bytes() {
+    auto file = std::fopen("/proc/self/statm", "r");
+    if (!file) {
+        return 0;
+    }
+    auto total_pages = 0L, resident_pages = 0L;
+    auto fields = std::fscanf(file, "%ld %ld", &total_pages, &resident_pages);
+    std::fclose(file);
+    return fields == 2 ? static_cast<size_t>(resident_pages) * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+}
+
+size_t peak_rss_bytes() {
+    auto usage = rusage();
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+#endif
+
+// Counting replacements of the global allocation functions (aligned variants keep the defaults)
+void* operator new(std::size_t size) {
+    return counted_alloc(size);
+}
+
+void* operator new[](std::size_t size) {
+    return counted_alloc(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return counted_alloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return counted_alloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
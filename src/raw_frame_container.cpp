@@ -0,0 +1,173 @@
+#include "raw_frame_container.hpp"
+#include <cstring>
+#include <limits>
+
+namespace {
+
+uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}
+
+bool RawFrameRecorder::open(const std::string& output_path) {
+    close();
+    path = output_path;
+    file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        logger.error("[RawFrameRecorder][ERROR] Could not create " + path);
+        return false;
+    }
+    header = {};
+    std::memcpy(header.magic, RAW_FRAME_MAGIC, sizeof(header.magic));
+    header.version = RAW_FRAME_VERSION;
+    header.data_offset = RAW_FRAME_ALIGNMENT;
+    timestamps.clear();
+
+    // Placeholder header, rewritten on close
+    padding.assign(RAW_FRAME_ALIGNMENT, 0);
+    file.write(padding.data(), static_cast<std::streamsize>(header.data_offset));
+    return true;
+}
+
+bool RawFrameRecorder::write(const Frame& frame) {
+    if (!file.is_open() || frame.image.empty()) {
+        return false;
+    }
+    auto channels = pixel_format_channels(frame.format);
+    if (frame.image.channels() != channels || frame.image.depth() != CV_8U) {
+        logger.error("[RawFrameRecorder][ERROR] Frame does not match its pixel format");
+        return false;
+    }
+
+    if (header.frame_count == 0) {
+        header.width = static_cast<uint32_t>(frame.image.cols);
+        header.height = static_cast<uint32_t>(frame.image.rows);
+        header.format = static_cast<uint32_t>(frame.format);
+        header.row_stride = header.width * channels;
+        header.frame_stride = align_up(static_cast<uint64_t>(header.row_stride) * header.height, RAW_FRAME_ALIGNMENT);
+        padding.assign(header.frame_stride - static_cast<uint64_t>(header.row_stride) * header.height, 0);
+    } else if (frame.image.cols != static_cast<int>(header.width) || frame.image.rows != static_cast<int>(header.height) ||
+               static_cast<uint32_t>(frame.format) != header.format) {
+        logger.error("[RawFrameRecorder][ERROR] Frame geometry changed during recording, frame dropped");
+        return false;
+    }
+
+    // Rows are written one by one so ROI views with a larger step are packed
+    for (int y = 0; y < frame.image.rows; ++y) {
+        file.write(reinterpret_cast<const char*>(frame.image.ptr<uchar>(y)), header.row_stride);
+    }
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    timestamps.push_back(frame.timestamp_us);
+    ++header.frame_count;
+    return file.good();
+}
+
+void RawFrameRecorder::close() {
+    if (!file.is_open()) {
+        return;
+    }
+    header.timestamps_offset = header.data_offset + header.frame_count * header.frame_stride;
+    file.write(reinterpret_cast<const char*>(timestamps.data()),
+               static_cast<std::streamsize>(timestamps.size() * sizeof(int64_t)));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    logger.info("[RawFrameRecorder][INFO] Wrote " + std::to_string(header.frame_count) + " frames to " + path);
+}
+
+RawFrameSource::RawFrameSource(const std::string& path, bool loop_frames) : loop(loop_frames) {
+    if (!mapped.open(path)) {
+        logger.error("[RawFrameSource][ERROR] Could not map " + path);
+        return;
+    }
+    if (mapped.size() < sizeof(RawFrameHeader)) {
+        logger.error("[RawFrameSource][ERROR] File too small: " + path);
+        return;
+    }
+    std::memcpy(&header, mapped.data(), sizeof(header));
+    if (std::memcmp(header.magic, RAW_FRAME_MAGIC, sizeof(header.magic)) != 0 || header.version != RAW_FRAME_VERSION) {
+        logger.error("[RawFrameSource][ERROR] Not a raw frame container: " + path);
+        return;
+    }
+    auto format_valid = header.format == static_cast<uint32_t>(PixelFormat::BGR) ||
+                        header.format == static_cast<uint32_t>(PixelFormat::BGRA);
+    if (!format_valid || !geometry_valid()) {
+        logger.error("[RawFrameSource][ERROR] Invalid frame geometry in " + path);
+        return;
+    }
+    if (header.frame_count == 0 || !layout_fits(mapped.size())) {
+        logger.error("[RawFrameSource][ERROR] Truncated or empty container: " + path);
+        return;
+    }
+    timestamps = reinterpret_cast<const int64_t*>(mapped.data() + header.timestamps_offset);
+    opened = true;
+}
+
+bool RawFrameSource::geometry_valid() const {
+    // frame_view builds a cv::Mat straight over the mapping: every stride must cover its rows
+    auto channels = static_cast<uint64_t>(pixel_format_channels(static_cast<PixelFormat>(header.format)));
+    auto max_dimension = static_cast<uint64_t>(std::numeric_limits<int>::max());
+    return header.width > 0 && header.height > 0 && header.width <= max_dimension && header.height <= max_dimension &&
+           header.row_stride >= header.width * channels &&
+           header.frame_stride / header.height >= header.row_stride &&
+           header.data_offset >= sizeof(RawFrameHeader);
+}
+
+bool RawFrameSource::layout_fits(uint64_t file_size) const {
+    // Frames, then timestamps, inside the file; products checked before they can wrap
+    auto max = std::numeric_limits<uint64_t>::max();
+    if (header.frame_count > max / header.frame_stride || header.frame_count > max / sizeof(int64_t)) {
+        return false;
+    }
+    auto frames_bytes = header.frame_count * header.frame_stride;
+    auto timestamps_bytes = header.frame_count * sizeof(int64_t);
+    return header.data_offset <= file_size && frames_bytes <= file_size - header.data_offset &&
+           header.timestamps_offset >= header.data_offset + frames_bytes &&
+           header.timestamps_offset % alignof(int64_t) == 0 &&
+           header.timestamps_offset <= file_size && timestamps_bytes <= file_size - header.timestamps_offset;
+}
+
+bool RawFrameSource::is_raw_file(const std::string& path) {
+    return path.size() > 4 && path.compare(path.size() - 4, 4, ".raw") == 0;
+}
+
+cv::Mat RawFrameSource::frame_view(uint64_t frame_index) const {
+    auto type = header.format == static_cast<uint32_t>(PixelFormat::BGRA) ? CV_8UC4 : CV_8UC3;
+    auto pixels = mapped.data() + header.data_offset + frame_index * header.frame_stride;
+    // The mapping is read-only: callers must not write into this view
+    return cv::Mat(static_cast<int>(header.height), static_cast<int>(header.width), type,
+                   const_cast<uint8_t*>(pixels), header.row_stride);
+}
+
+bool RawFrameSource::seek(int64_t frame_index) {
+    if (!opened || frame_index < 0 || static_cast<uint64_t>(frame_index) >= header.frame_count) {
+        return false;
+    }
+    next_frame = static_cast<uint64_t>(frame_index);
+    return true;
+}
+
+bool RawFrameSource::grab(const cv::Rect& region, Frame& frame) {
+    if (!opened) {
+        return false;
+    }
+    if (next_frame >= header.frame_count) {
+        if (!loop) return false;
+        next_frame = 0;
+    }
+
+    auto roi = clamp_region(region);
+    if (roi.empty()) {
+        logger.error("[RawFrameSource][ERROR] Requested region is outside the frame");
+        return false;
+    }
+
+    frame.image = frame_view(next_frame)(roi);
+    frame.format = get_format();
+    frame.region = roi;
+    frame.frame_id = static_cast<int64_t>(next_frame);
+    frame.timestamp_us = timestamps[next_frame];
+    ++next_frame;
+    return true;
+}
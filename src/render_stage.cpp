@@ -0,0 +1,100 @@
+#include "render_stage.hpp"
+#include "metrics.hpp"
+#include "memory_tracker.hpp"
+#include <chrono>
+#include <utility>
+
+RenderStage::RenderStage(const std::string& window, const cv::Size& fov, bool use_thread, const std::string& config_file)
+    : visualizer(config_file), window_name(window), fov_size(fov), threaded(use_thread) {
+    if (threaded) {
+        render_thread = std::thread(&RenderStage::render_loop, this);
+    } else {
+        cv::namedWindow(window_name, cv::WINDOW_NORMAL);
+        cv::resizeWindow(window_name, fov_size.width, fov_size.height);
+    }
+}
+
+RenderStage::~RenderStage() {
+    if (render_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mailbox_mutex);
+            stopping = true;
+        }
+        frame_available.notify_one();
+        render_thread.join();
+    }
+}
+
+void RenderStage::submit(const cv::Mat& frame, const FrameDetections& detections, const std::string& overlay) {
+    auto scope = StageScope(PipelineStage::Render);
+    if (!threaded) {
+        // Drawn before the caller's next frame: the result views are used as they are
+        auto& slot = slots[write_slot];
+        frame.copyTo(slot.image);
+        render(slot.image, detections, overlay);
+        return;
+    }
+
+    // Fill the producer slot outside the lock (copyTo and assign reuse the slot buffers), then publish it.
+    // This is the one copy of the results: the render thread outlives the producer's frame.
+    auto& slot = slots[write_slot];
+    frame.copyTo(slot.image);
+    slot.detections.assign(detections.detections.begin(), detections.detections.end());
+    slot.fov.assign(detections.fov.begin(), detections.fov.end());
+    slot.overlay = overlay;
+    {
+        std::lock_guard<std::mutex> lock(mailbox_mutex);
+        if (has_pending) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            detection_metrics().render_dropped.add();
+        }
+        std::swap(write_slot, pending_slot);
+        has_pending = true;
+    }
+    frame_available.notify_one();
+}
+
+void RenderStage::render(cv::Mat& image, const FrameDetections& detections, const std::string& overlay) {
+    auto scope = StageScope(PipelineStage::Render);
+    visualizer.draw_fov_detections_in_place(image, detections, fov_size.width, fov_size.height);
+    if (!overlay.empty()) {
+        cv::putText(image, overlay, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(0, 255, 0), 2);
+    }
+    cv::imshow(window_name, image);
+    rendered.fetch_add(1, std::memory_order_relaxed);
+
+    // Press 'q' to stop. pollKey pumps window events without waitKey's 1 ms minimum,
+    // so drawing inline (render_thread = false) does not stretch the frame.
+    if (cv::pollKey() == 'q') {
+        quit.store(true, std::memory_order_relaxed);
+    }
+}
+
+void RenderStage::render_loop() {
+    // HighGUI windows belong to the thread that created them
+    cv::namedWindow(window_name, cv::WINDOW_NORMAL);
+    cv::resizeWindow(window_name, fov_size.width, fov_size.height);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mailbox_mutex);
+            frame_available.wait_for(lock, std::chrono::milliseconds(15), [this] { return has_pending || stopping; });
+            if (stopping) {
+                break;
+            }
+            if (!has_pending) {
+                // No new frame: keep the window responsive and the quit key polled
+                lock.unlock();
+                if (cv::pollKey() == 'q') {
+                    quit.store(true, std::memory_order_relaxed);
+                }
+                continue;
+            }
+            std::swap(render_slot, pending_slot);
+            has_pending = false;
+        }
+        auto& slot = slots[render_slot];
+        render(slot.image, FrameDetections{slot.detections, slot.fov}, slot.overlay);
+    }
+    cv::destroyWindow(window_name);
+}
@@ -0,0 +1,314 @@
+#include "logger.hpp"
+#include "config_manager.hpp"
+#include "yolov8_detector.hpp"
+#include "file_frame_source.hpp"
+#include "raw_frame_container.hpp"
+#include "annotated_video_writer.hpp"
+#include "memory_tracker.hpp"
+#include "cpu_dispatch.hpp"
+#include "startup_profile.hpp"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+namespace {
+
+struct ReplayOptions {
+    std::string input;
+    std::string model_path;
+    std::string record_path;
+    std::string output_path;
+    std::string isa;
+    std::string backend;
+    std::string swap_model_path;
+    int64_t swap_at = 100;
+    int64_t max_frames = -1;
+    int warmup_frames = 5;
+    cv::Size region;
+    bool loop = false;
+    bool bgra = false;
+};
+
+void print_usage() {
+    std::cout << "Usage: dogai_replay <input> [options]\n"
+              << "  <input>              .raw container, video file, image or image directory\n"
+              << "  --model <path>       ONNX model (default: [Model] model_path)\n"
+              << "  --frames <n>         stop after n frames\n"
+              << "  --warmup <n>         frames excluded from statistics (default 5)\n"
+              << "  --region <w>x<h>     centered region to grab (default: full frame)\n"
+              << "  --loop               restart the input when it ends (needs --frames)\n"
+              << "  --bgra               decode files as BGRA like the screen capture\n"
+              << "  --record <out.raw>   record the grabbed frames into a raw container\n"
+              << "  --output <path>      write annotated frames (video, or .raw) using [Output] settings\n"
+              << "  --isa <name>         kernel variant: generic, sse42, avx2, avx512 (default: [CPU] kernel_isa)\n"
+              << "  --backend <name>     inference backend: onnxruntime, opencv (default: [Model] backend)\n"
+              << "  --swap <path>        hot swap to this model during the replay\n"
+              << "  --swap-at <n>        frame at which the swap is requested (default 100)\n";
+}
+
+bool parse_options(int argc, char** argv, ReplayOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        auto arg = std::string(argv[i]);
+        auto has_value = i + 1 < argc;
+        if (arg == "--model" && has_value) {
+            options.model_path = argv[++i];
+        } else if (arg == "--record" && has_value) {
+            options.record_path = argv[++i];
+        } else if (arg == "--output" && has_value) {
+            options.output_path = argv[++i];
+        } else if (arg == "--isa" && has_value) {
+            options.isa = argv[++i];
+        } else if (arg == "--backend" && has_value) {
+            options.backend = argv[++i];
+        } else if (arg == "--swap" && has_value) {
+            options.swap_model_path = argv[++i];
+        } else if (arg == "--swap-at" && has_value) {
+            options.swap_at = std::stoll(argv[++i]);
+        } else if (arg == "--frames" && has_value) {
+            options.max_frames = std::stoll(argv[++i]);
+        } else if (arg == "--warmup" && has_value) {
+            options.warmup_frames = std::stoi(argv[++i]);
+        } else if (arg == "--region" && has_value) {
+            auto value = std::string(argv[++i]);
+            auto x = value.find('x');
+            if (x == std::string::npos) return false;
+            options.region = cv::Size(std::stoi(value.substr(0, x)), std::stoi(value.substr(x + 1)));
+        } else if (arg == "--loop") {
+            options.loop = true;
+        } else if (arg == "--bgra") {
+            options.bgra = true;
+        } else if (!arg.empty() && arg[0] != '-' && options.input.empty()) {
+            options.input = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options.input.empty() && (!options.loop || options.max_frames > 0);
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    auto index = static_cast<size_t>(p * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// FNV-1a over the detections, to check that two replays are bit-exact
+uint64_t hash_detections(uint64_t hash, Span<const Detection> detections) {
+    auto mix = [&hash](const void* data, size_t size) {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+    // Detection is six packed 4-byte fields: the record is hashed as is
+    for (const auto& det : detections) {
+        mix(&det, sizeof(det));
+    }
+    return hash;
+}
+
+}
+
+int main(int argc, char** argv) {
+    auto options = ReplayOptions();
+    try {
+        if (!parse_options(argc, argv, options)) {
+            print_usage();
+            return 1;
+        }
+    } catch (const std::exception&) {
+        print_usage();
+        return 1;
+    }
+
+    auto startup = StartupProfile();
+    auto step_start = StartupProfile::Clock::now();
+    auto config = ConfigManager("blood.cfg");
+    MemoryTracker::configure(config);
+    CpuDispatch::configure(config);
+    if (!options.isa.empty()) {
+        auto isa = CpuIsa::Generic;
+        auto automatic = false;
+        if (!CpuDispatch::parse_isa(options.isa, isa, automatic)) {
+            print_usage();
+            return 1;
+        }
+        CpuDispatch::select(automatic ? CpuDispatch::detect() : isa);
+    }
+    if (!options.backend.empty()) {
+        config.set_string("Model", "backend", options.backend);
+    }
+    if (options.model_path.empty()) {
+        options.model_path = config.get_string("Model", "model_path", "models/blood.onnx");
+    }
+    startup.record("config", step_start);
+
+    // Session creation and warmup overlap opening the input
+    auto detector_init = std::async(std::launch::async, [&config, &startup, model_path = options.model_path] {
+        auto start = StartupProfile::Clock::now();
+        auto detector = std::make_unique<YOLOv8>(model_path, config, 0.2f, 0.2f, &startup);
+        startup.record("detector", start);
+        return detector;
+    });
+
+    step_start = StartupProfile::Clock::now();
+    auto source = open_file_frame_source(options.input, options.loop, options.bgra ? PixelFormat::BGRA : PixelFormat::BGR);
+    if (!source->is_open()) {
+        logger.error("[REPLAY][ERROR] Could not open input: " + options.input);
+        return 1;
+    }
+
+    auto recorder = RawFrameRecorder();
+    if (!options.record_path.empty() && !recorder.open(options.record_path)) {
+        return 1;
+    }
+    auto recording_source = RecordingFrameSource(*source, recorder);
+    auto& frames = options.record_path.empty() ? *source : static_cast<FrameSource&>(recording_source);
+    startup.record("source", step_start);
+
+    try {
+        auto detector_owner = detector_init.get();
+        auto& detector = *detector_owner;
+        auto video_output = std::unique_ptr<AnnotatedVideoWriter>();
+        if (!options.output_path.empty()) {
+            auto output_options = AnnotatedVideoWriter::options_from_config(config);
+            output_options.path = options.output_path;
+            video_output = std::make_unique<AnnotatedVideoWriter>(output_options);
+        }
+        auto region = options.region.empty() ? cv::Rect() : frames.centered_region(options.region.width, options.region.height);
+
+        auto frame = Frame();
+        auto latencies = std::vector<double>();
+        auto preprocess_total = 0.0, inference_total = 0.0, postprocess_total = 0.0, gate_total = 0.0;
+        auto total_detections = size_t(0);
+        auto detection_hash = uint64_t(14695981039346656037ull);
+        auto frame_count = int64_t(0);
+        auto measured_start = std::chrono::steady_clock::now();
+        auto memory_report = MemoryReport();
+        // Hot swap: frame it was requested at, frame it went live at, worst frame while loading
+        auto swap_requested = int64_t(-1);
+        auto swap_live = int64_t(-1);
+        auto swap_max_ms = 0.0;
+
+        while ((options.max_frames < 0 || frame_count < options.max_frames) && frames.grab(region, frame)) {
+            if (!options.swap_model_path.empty() && frame_count == options.swap_at && detector.request_model_swap(options.swap_model_path)) {
+                swap_requested = frame_count;
+            }
+            auto start = std::chrono::steady_clock::now();
+            auto detections = detector.detect_objects(frame.image);
+            auto end = std::chrono::steady_clock::now();
+            if (swap_requested >= 0 && swap_live < 0) {
+                swap_max_ms = std::max(swap_max_ms, std::chrono::duration<double, std::milli>(end - start).count());
+                if (!detector.is_swap_pending()) {
+                    swap_live = frame_count;
+                }
+            }
+
+            if (video_output) {
+                video_output->submit(frame.image, detections, frame.timestamp_us);
+            }
+
+            ++frame_count;
+            if (frame_count == 1) {
+                std::cout << "[REPLAY] Startup: " << startup.format() << " to first detection\n";
+            }
+            detection_hash = hash_detections(detection_hash, detections);
+            if (frame_count <= options.warmup_frames) {
+                measured_start = end;
+                memory_report = MemoryReport();
+                continue;
+            }
+            memory_report.on_frame();
+            const auto& timings = detector.get_last_timings();
+            latencies.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            preprocess_total += timings.preprocess_ms;
+            inference_total += timings.inference_ms;
+            postprocess_total += timings.postprocess_ms;
+            gate_total += timings.gate_ms;
+            total_detections += detections.size();
+        }
+        auto measured_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - measured_start).count();
+        recorder.close();
+        if (video_output) {
+            video_output->close();
+        }
+
+        auto measured = static_cast<double>(latencies.size());
+        auto mean = measured > 0 ? std::accumulate(latencies.begin(), latencies.end(), 0.0) / measured : 0.0;
+        std::cout << std::fixed << std::setprecision(3)
+                  << "[REPLAY] Input: " << options.input << "\n"
+                  << "[REPLAY] Model: " << options.model_path << "\n"
+                  << "[REPLAY] Backend: " << detector.get_backend_name() << "\n"
+                  << "[REPLAY] CPU kernels: " << CpuDispatch::describe() << "\n"
+                  << "[REPLAY] Frames: " << frame_count << " (" << latencies.size() << " measured)\n"
+                  << "[REPLAY] Throughput: " << (measured_seconds > 0 ? measured / measured_seconds : 0.0) << " FPS\n"
+                  << "[REPLAY] Latency ms: mean " << mean << " | p50 " << percentile(latencies, 0.5)
+                  << " | p99 " << percentile(latencies, 0.99) << " | max " << percentile(latencies, 1.0) << "\n"
+                  << "[REPLAY] Stage ms: preprocess " << (measured > 0 ? preprocess_total / measured : 0.0)
+                  << " | inference " << (measured > 0 ? inference_total / measured : 0.0)
+                  << " | postprocess " << (measured > 0 ? postprocess_total / measured : 0.0) << "\n"
+                  << "[REPLAY] Detections: " << total_detections << "\n"
+                  << "[REPLAY] Detection hash: " << std::hex << detection_hash << std::dec << "\n";
+
+        // Allocations per measured frame and stage, with [Debug] enable_memory_tracking
+        auto memory_line = memory_report.take();
+        if (!memory_line.empty()) {
+            std::cout << "[REPLAY] " << memory_line << "\n"
+                      << "[REPLAY] Backend arena: " << detector.get_arena_stats() << "\n";
+        }
+
+        if (swap_requested >= 0) {
+            auto swap = detector.get_swap_stats();
+            std::cout << "[REPLAY] Model swap: " << (swap.swaps > 0 ? swap.model_path : std::string("failed")) << " requested at frame "
+                      << swap_requested << ", live at frame " << swap_live << " | load " << swap.last_load_ms
+                      << " ms | worst frame while loading " << swap_max_ms << " ms\n";
+        }
+
+        if (video_output) {
+            auto stats = video_output->get_stats();
+            std::cout << "[REPLAY] Output: " << stats.written << " written | " << stats.dropped << " dropped | "
+                      << stats.downsampled << " downsampled | max queue " << stats.max_queue_depth << "\n";
+        }
+
+        // Mean per-tile cost (detections are totals)
+        if (auto tiled = detector.get_tiled_detector()) {
+            for (const auto& report : tiled->get_average_reports()) {
+                std::cout << "[REPLAY] Tile " << report.region.x << "," << report.region.y << " " << report.region.width
+                          << "x" << report.region.height << ": " << report.total_ms << " ms (inference "
+                          << report.timings.inference_ms << ") | " << report.detections << " detections\n";
+            }
+        }
+
+        // Skip and cascade statistics cover every frame, warmup included
+        if (auto change = detector.get_change_detector()) {
+            const auto& stats = change->get_stats();
+            std::cout << "[REPLAY] Frame skip: reused " << stats.reused << " / " << stats.frames
+                      << " | changed " << stats.changed << " | reuse limit hit " << stats.expired << "\n";
+        }
+        if (auto cascade = detector.get_cascade()) {
+            const auto& stats = cascade->get_stats();
+            auto frames = static_cast<double>(std::max<uint64_t>(1, stats.frames));
+            auto negatives_checked = static_cast<double>(std::max<uint64_t>(1, stats.negatives_checked));
+            std::cout << "[REPLAY] Cascade" << (cascade->get_options().audit ? " (audit)" : "") << ": gate "
+                      << (measured > 0 ? gate_total / measured : 0.0) << " ms | hit rate " << 100.0 * stats.gate_fired / frames
+                      << "% | full runs " << stats.full_runs << " (held " << stats.held << ", refresh " << stats.refreshes
+                      << ") | skipped " << 100.0 * stats.skipped / frames << "%\n"
+                      << "[REPLAY] Cascade misses: " << stats.gate_misses << " gate-negative frames with detections ("
+                      << 100.0 * stats.gate_misses / negatives_checked << "% of " << stats.negatives_checked << " checked)";
+            if (cascade->get_options().audit) {
+                std::cout << " | " << stats.skipped_with_detections << " would-be-skipped frames with detections";
+            }
+            std::cout << "\n";
+        }
+    } catch (const std::exception& e) {
+        logger.error("[REPLAY][ERROR] Exception captured: " + std::string(e.what()));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include "result_ring.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace {
+
+size_t slot_bytes(uint32_t max_detections) {
+    return sizeof(ResultSlotHeader) + static_cast<size_t>(max_detections) * sizeof(ResultRecord);
+}
+
+}
+
+ResultRingPublisher::ResultRingPublisher(const std::string& name, uint32_t slot_count, uint32_t max_detections) {
+    slot_count = std::max<uint32_t>(1, slot_count);
+    max_detections = std::max<uint32_t>(1, max_detections);
+    auto slot_size = slot_bytes(max_detections);
+    if (!memory.create(name, sizeof(ResultRingHeader) + slot_count * slot_size)) {
+        logger.error("[ResultRing][ERROR] Could not create shared memory segment: " + name);
+        return;
+    }
+
+    // Fresh segments are zero-filled: every slot sequence starts even (stable, empty)
+    header = new (memory.data()) ResultRingHeader();
+    header->version = RESULT_RING_VERSION;
+    header->slot_count = slot_count;
+    header->max_detections = max_detections;
+    header->slot_size = static_cast<uint32_t>(slot_size);
+    header->write_index.store(0, std::memory_order_relaxed);
+    std::memcpy(header->magic, RESULT_RING_MAGIC, sizeof(header->magic));
+    std::atomic_thread_fence(std::memory_order_release);
+    logger.info("[ResultRing][INFO] Publishing results to shared memory '" + name + "' (" + std::to_string(slot_count) +
+                " slots, " + std::to_string(max_detections) + " detections each)");
+}
+
+void ResultRingPublisher::publish(int64_t frame_id, int64_t timestamp_us, const FrameDetections& detections) {
+    if (!header) {
+        return;
+    }
+    auto index = header->write_index.load(std::memory_order_relaxed);
+    auto slot_data = memory.data() + sizeof(ResultRingHeader) + (index % header->slot_count) * header->slot_size;
+    auto slot = reinterpret_cast<ResultSlotHeader*>(slot_data);
+    auto records = reinterpret_cast<ResultRecord*>(slot_data + sizeof(ResultSlotHeader));
+
+    // Seqlock write: odd sequence, payload, even sequence
+    auto sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto count = std::min<size_t>(detections.size(), header->max_detections);
+    slot->frame_id = frame_id;
+    slot->timestamp_us = timestamp_us;
+    slot->count = static_cast<uint32_t>(count);
+    auto has_metrics = detections.fov.size() == detections.size();
+    for (size_t i = 0; i < count; ++i) {
+        const auto& det = detections.detections[i];
+        records[i] = ResultRecord{det.x1, det.y1, det.width(), det.height(), det.score, det.class_id,
+                                  has_metrics ? detections.fov[i].distance : 0.0f,
+                                  has_metrics ? detections.fov[i].angle : 0.0f};
+    }
+
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+    header->write_index.store(index + 1, std::memory_order_release);
+}
+
+bool ResultRingReader::open(const std::string& name) {
+    header = nullptr;
+    if (!memory.open_read_only(name) || memory.size() < sizeof(ResultRingHeader)) {
+        return false;
+    }
+    auto candidate = reinterpret_cast<const ResultRingHeader*>(memory.data());
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (std::memcmp(candidate->magic, RESULT_RING_MAGIC, sizeof(candidate->magic)) != 0 ||
+        candidate->version != RESULT_RING_VERSION ||
+        candidate->slot_size != slot_bytes(candidate->max_detections) ||
+        memory.size() < sizeof(ResultRingHeader) + static_cast<size_t>(candidate->slot_count) * candidate->slot_size) {
+        memory.close();
+        return false;
+    }
+    header = candidate;
+    // Start at the live edge: history older than the attach time is not replayed
+    cursor = header->write_index.load(std::memory_order_acquire);
+    return true;
+}
+
+bool ResultRingReader::read_slot(uint64_t index, RingResult& result) const {
+    auto slot_data = memory.data() + sizeof(ResultRingHeader) + (index % header->slot_count) * header->slot_size;
+    auto slot = reinterpret_cast<const ResultSlotHeader*>(slot_data);
+    auto records = reinterpret_cast<const ResultRecord*>(slot_data + sizeof(ResultSlotHeader));
+
+    // Seqlock read: retry while the publisher is inside the slot
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        auto before = slot->sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        result.frame_id = slot->frame_id;
+        result.timestamp_us = slot->timestamp_us;
+        auto count = std::min(slot->count, header->max_detections);
+        result.records.resize(count);
+        std::memcpy(result.records.data(), records, count * sizeof(ResultRecord));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) != before) {
+            continue;
+        }
+        // The slot may already hold a newer lap than the one asked for
+        if (header->write_index.load(std::memory_order_acquire) > index + header->slot_count) {
+            return false;
+        }
+        result.index = index;
+        return true;
+    }
+    return false;
+}
+
+bool ResultRingReader::read_next(RingResult& result) {
+    if (!header) {
+        return false;
+    }
+    auto written = header->write_index.load(std::memory_order_acquire);
+    if (cursor >= written) {
+        return false;
+    }
+    // Lapped by the publisher: jump to the oldest slot that is still intact
+    if (written - cursor > header->slot_count) {
+        auto oldest = written - header->slot_count + 1;
+        lost += oldest - cursor;
+        cursor = oldest;
+    }
+    while (cursor < header->write_index.load(std::memory_order_acquire)) {
+        if (read_slot(cursor, result)) {
+            ++cursor;
+            return true;
+        }
+        ++lost;
+        ++cursor;
+    }
+    return false;
+}
+
+bool ResultRingReader::read_latest(RingResult& result) {
+    if (!header) {
+        return false;
+    }
+    auto written = header->write_index.load(std::memory_order_acquire);
+    if (written == 0 || !read_slot(written - 1, result)) {
+        return false;
+    }
+    cursor = written;
+    return true;
+}
@@ -0,0 +1,60 @@
+#include "logger.hpp"
+#include "result_ring.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+// Example consumer of the shared-memory result ring: prints every result (or
+// only the newest with --latest) and the read rate once per second.
+int main(int argc, char** argv) {
+    auto name = std::string("dogai_results");
+    auto latest_only = false;
+    auto quiet = false;
+    for (int i = 1; i < argc; ++i) {
+        auto arg = std::string(argv[i]);
+        if (arg == "--latest") {
+            latest_only = true;
+        } else if (arg == "--quiet") {
+            quiet = true;
+        } else if (!arg.empty() && arg[0] != '-') {
+            name = arg;
+        } else {
+            std::cout << "Usage: dogai_ring_reader [name] [--latest] [--quiet]\n";
+            return 1;
+        }
+    }
+
+    auto reader = ResultRingReader();
+    while (!reader.open(name)) {
+        std::cout << "[RING] Waiting for publisher '" << name << "'..." << std::endl;
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+
+    auto result = RingResult();
+    auto results_read = uint64_t(0);
+    auto last_report = std::chrono::steady_clock::now();
+    while (true) {
+        auto got = latest_only ? reader.read_latest(result) : reader.read_next(result);
+        if (!got) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        } else {
+            ++results_read;
+            if (!quiet) {
+                std::cout << "[RING] #" << result.index << " frame " << result.frame_id << " | " << result.records.size() << " detections";
+                for (const auto& record : result.records) {
+                    std::cout << " | c" << record.class_id << " " << std::fixed << std::setprecision(2) << record.score
+                              << " @" << static_cast<int>(record.x) << "," << static_cast<int>(record.y);
+                }
+                std::cout << "\n";
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_report >= std::chrono::seconds(1)) {
+            std::cout << "[RING] " << results_read << " results/s | lost " << reader.get_lost_count() << std::endl;
+            results_read = 0;
+            last_report = now;
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#include "logger.hpp"
+#include "config_manager.hpp"
+#include "detection_server.hpp"
+#include "file_frame_source.hpp"
+#include "metrics_exporter.hpp"
+#include "memory_tracker.hpp"
+#include "cpu_dispatch.hpp"
+#include <memory>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+void print_usage() {
+    std::cout << "Usage: dogai_server <input> [<input> ...] [options]\n"
+              << "  <input>              .raw container, video file, image or image directory (one stream each)\n"
+              << "  --model <path>       ONNX model (default: [Model] model_path)\n"
+              << "  --workers <n>        worker threads (default: [Server] num_workers)\n"
+              << "  --sessions <n>       model sessions shared by the workers (default: [Server] num_sessions)\n"
+              << "  --backend <name>     inference backend: onnxruntime, opencv (default: [Model] backend)\n"
+              << "  --frames <n>         frames per stream\n"
+              << "  --region <w>x<h>     centered region to grab (default: full frame)\n"
+              << "  --loop               restart inputs when they end (needs --frames)\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    auto config = ConfigManager("blood.cfg");
+    MemoryTracker::configure(config);
+    CpuDispatch::configure(config);
+    auto model_path = config.get_string("Model", "model_path", "models/blood.onnx");
+    auto inputs = std::vector<std::string>();
+    auto num_workers = 0;
+    auto num_sessions = 0;
+    auto backend = std::string();
+    auto max_frames = int64_t(-1);
+    auto region_size = cv::Size();
+    auto loop = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            auto arg = std::string(argv[i]);
+            auto has_value = i + 1 < argc;
+            if (arg == "--model" && has_value) {
+                model_path = argv[++i];
+            } else if (arg == "--workers" && has_value) {
+                num_workers = std::stoi(argv[++i]);
+            } else if (arg == "--sessions" && has_value) {
+                num_sessions = std::stoi(argv[++i]);
+            } else if (arg == "--backend" && has_value) {
+                backend = argv[++i];
+            } else if (arg == "--frames" && has_value) {
+                max_frames = std::stoll(argv[++i]);
+            } else if (arg == "--region" && has_value) {
+                auto value = std::string(argv[++i]);
+                auto x = value.find('x');
+                if (x == std::string::npos) throw std::invalid_argument(value);
+                region_size = cv::Size(std::stoi(value.substr(0, x)), std::stoi(value.substr(x + 1)));
+            } else if (arg == "--loop") {
+                loop = true;
+            } else if (!arg.empty() && arg[0] != '-') {
+                inputs.push_back(arg);
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        }
+    } catch (const std::exception&) {
+        print_usage();
+        return 1;
+    }
+    if (inputs.empty() || (loop && max_frames <= 0)) {
+        print_usage();
+        return 1;
+    }
+
+    try {
+        auto server = DetectionServer(model_path, num_workers, num_sessions, backend);
+        auto metrics_exporter = std::unique_ptr<MetricsExporter>();
+        if (config.get_string("Metrics", "enabled", "false") == "true") {
+            metrics_exporter = std::make_unique<MetricsExporter>(config.get_string("Metrics", "listen", "127.0.0.1:9464"));
+        }
+        for (const auto& input : inputs) {
+            auto source = open_file_frame_source(input, loop);
+            if (!source->is_open()) {
+                logger.error("[SERVER][ERROR] Could not open input: " + input);
+                return 1;
+            }
+            auto region = region_size.empty() ? cv::Rect() : source->centered_region(region_size.width, region_size.height);
+            server.add_stream(input, std::move(source), region, max_frames);
+        }
+
+        auto memory_before = MemoryTracker::Snapshot();
+        MemoryTracker::snapshot(memory_before);
+        auto report = server.run();
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << "[SERVER] Workers: " << server.get_num_workers() << " | Sessions: " << server.get_num_sessions()
+                  << " (" << server.get_backend_name() << ")"
+                  << " | Streams: " << report.streams.size() << " | CPU kernels: " << CpuDispatch::describe() << "\n";
+        std::cout << "[SERVER] Session RSS MB: first " << server.get_first_session_bytes() / (1024.0 * 1024.0);
+        if (server.get_num_sessions() > 1) {
+            std::cout << " | per additional session " << server.get_additional_session_bytes() / (1024.0 * 1024.0);
+        }
+        std::cout << "\n";
+        for (const auto& stream : report.streams) {
+            std::cout << "[SERVER] " << stream.name << ": " << stream.frames << " frames | latency ms mean " << stream.mean_ms
+                      << " | p50 " << stream.p50_ms << " | p99 " << stream.p99_ms << " | max " << stream.max_ms << "\n";
+        }
+        std::cout << "[SERVER] Total: " << report.total_frames << " frames in " << report.wall_seconds << " s | "
+                  << report.throughput_fps << " FPS aggregate | " << report.steals << " steals\n";
+        if (MemoryTracker::is_enabled()) {
+            auto memory_after = MemoryTracker::Snapshot();
+            MemoryTracker::snapshot(memory_after);
+            std::cout << "[SERVER] " << MemoryTracker::format_report(memory_before, memory_after, report.total_frames) << "\n";
+        }
+    } catch (const std::exception& e) {
+        logger.error("[SERVER][ERROR] Exception captured: " + std::string(e.what()));
+        return 1;
+    }
+    return 0;
+}
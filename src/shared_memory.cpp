@@ -0,0 +1,160 @@
+#include "shared_memory.hpp"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+namespace {
+
+std::string mapping_name(const std::string& name) {
+    return "Local\\" + name;
+}
+
+}
+
+bool SharedMemory::create(const std::string& name, size_t size) {
+    close();
+    auto size64 = static_cast<uint64_t>(size);
+    auto mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                      static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64 & 0xFFFFFFFFu),
+                                      mapping_name(name).c_str());
+    if (!mapping) {
+        return false;
+    }
+    auto view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    mapping_handle = mapping;
+    mapped_data = static_cast<uint8_t*>(view);
+    mapped_size = size;
+    segment_name = name;
+    owner = true;
+    return true;
+}
+
+bool SharedMemory::open_read_only(const std::string& name) {
+    close();
+    auto mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, mapping_name(name).c_str());
+    if (!mapping) {
+        return false;
+    }
+    auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    auto info = MEMORY_BASIC_INFORMATION();
+    VirtualQuery(view, &info, sizeof(info));
+    mapping_handle = mapping;
+    mapped_data = static_cast<uint8_t*>(view);
+    mapped_size = static_cast<size_t>(info.RegionSize);
+    segment_name = name;
+    owner = false;
+    return true;
+}
+
+void SharedMemory::close() {
+    if (mapped_data) {
+        UnmapViewOfFile(mapped_data);
+    }
+    if (mapping_handle) {
+        CloseHandle(mapping_handle);
+    }
+    // Windows removes the mapping with its last handle
+    mapped_data = nullptr;
+    mapped_size = 0;
+    mapping_handle = nullptr;
+    owner = false;
+}
+
+#else
+
+namespace {
+
+std::string shm_path(const std::string& name) {
+    return name.empty() || name[0] == '/' ? name : "/" + name;
+}
+
+}
+
+bool SharedMemory::create(const std::string& name, size_t size) {
+    close();
+    auto path = shm_path(name);
+    // Readers still attached to an old segment keep it alive; new readers see the new one
+    shm_unlink(path.c_str());
+    auto fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+    auto view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+    file_descriptor = fd;
+    mapped_data = static_cast<uint8_t*>(view);
+    mapped_size = size;
+    segment_name = path;
+    owner = true;
+    return true;
+}
+
+bool SharedMemory::open_read_only(const std::string& name) {
+    close();
+    auto path = shm_path(name);
+    auto fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    auto view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+    file_descriptor = fd;
+    mapped_data = static_cast<uint8_t*>(view);
+    mapped_size = static_cast<size_t>(st.st_size);
+    segment_name = path;
+    owner = false;
+    return true;
+}
+
+void SharedMemory::close() {
+    if (mapped_data) {
+        munmap(mapped_data, mapped_size);
+    }
+    if (file_descriptor >= 0) {
+        ::close(file_descriptor);
+    }
+    if (owner) {
+        shm_unlink(segment_name.c_str());
+    }
+    mapped_data = nullptr;
+    mapped_size = 0;
+    file_descriptor = -1;
+    owner = false;
+}
+
+#endif
@@ -0,0 +1,24 @@
+#include "startup_profile.hpp"
+#include <cstdio>
+
+void StartupProfile::record(const std::string& step, Clock::time_point start) {
+    auto ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    auto lock = std::lock_guard<std::mutex>(mutex);
+    steps.emplace_back(step, ms);
+}
+
+double StartupProfile::elapsed_ms() const {
+    return std::chrono::duration<double, std::milli>(Clock::now() - origin).count();
+}
+
+std::string StartupProfile::format() const {
+    auto result = std::string();
+    char line[64];
+    auto lock = std::lock_guard<std::mutex>(mutex);
+    for (const auto& step : steps) {
+        std::snprintf(line, sizeof(line), " %.1f ms | ", step.second);
+        result += step.first + line;
+    }
+    std::snprintf(line, sizeof(line), "total %.1f ms", elapsed_ms());
+    return result + line;
+}
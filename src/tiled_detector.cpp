@@ -0,0 +1,168 @@
+#include "tiled_detector.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// Evenly spaced tile origins covering [0, length) with tiles of size tile
+std::vector<int> tile_origins(int length, int tile, int overlap) {
+    if (length <= tile) {
+        return {0};
+    }
+    auto stride = std::max(1, tile - overlap);
+    auto count = static_cast<int>(std::ceil(static_cast<double>(length - tile) / stride)) + 1;
+    auto origins = std::vector<int>(count);
+    for (int i = 0; i < count; ++i) {
+        origins[i] = static_cast<int>(static_cast<int64_t>(length - tile) * i / (count - 1));
+    }
+    return origins;
+}
+
+}
+
+TiledDetector::TiledDetector(std::shared_ptr<ModelSlot> shared_models, ConfigManager& config, const TilingOptions& tiling_options)
+    : options(tiling_options), models(std::move(shared_models)) {
+    auto model = models->acquire();
+    merger.set_thresholds(model->get_conf_threshold(), model->get_iou_threshold());
+    merger.set_input_size(model->get_input_width(), model->get_input_height());
+    tile_size_from_model = options.tile_size <= 0;
+    set_tile_size(tile_size_from_model ? model->get_input_width() : options.tile_size);
+    options.max_tiles = std::max(1, options.max_tiles);
+    options.num_workers = std::max(1, options.num_workers);
+
+    pool = std::make_unique<WorkStealingPool>(options.num_workers);
+    for (int i = 0; i < options.num_workers; ++i) {
+        workspaces.push_back(std::make_unique<DetectionWorkspace>(*model, config));
+    }
+    logger.info("[TiledDetector][INFO] Tiles of " + std::to_string(options.tile_size) + " px, overlap " +
+                std::to_string(options.overlap) + " px, max " + std::to_string(options.max_tiles) + " tiles on " +
+                std::to_string(options.num_workers) + " workers");
+}
+
+TilingOptions TiledDetector::options_from_config(ConfigManager& config) {
+    auto result = TilingOptions();
+    result.enabled = config.get_string("Tiling", "enabled", "false") == "true";
+    result.tile_size = config.get_int("Tiling", "tile_size", result.tile_size);
+    result.overlap = config.get_int("Tiling", "overlap", result.overlap);
+    result.max_tiles = config.get_int("Tiling", "max_tiles", result.max_tiles);
+    result.num_workers = config.get_int("Tiling", "num_workers", result.num_workers);
+    result.global_view = config.get_string("Tiling", "global_view", "true") == "true";
+    result.merge_iou_threshold = config.get_float("Tiling", "merge_iou_threshold", result.merge_iou_threshold);
+    return result;
+}
+
+void TiledDetector::set_tile_size(int tile_size) {
+    options.tile_size = std::max(1, tile_size);
+    options.overlap = std::max(0, std::min(options.overlap, options.tile_size / 2));
+    tiles_frame_size = cv::Size();
+}
+
+bool TiledDetector::should_tile(const cv::Size& frame_size) const {
+    return frame_size.width > options.tile_size || frame_size.height > options.tile_size;
+}
+
+void TiledDetector::build_tiles(const cv::Size& frame_size) {
+    tiles_frame_size = frame_size;
+    tiles.clear();
+
+    // Grow the tile until the grid fits in max_tiles; larger tiles are downscaled to the model input
+    auto tile = options.tile_size;
+    auto xs = std::vector<int>();
+    auto ys = std::vector<int>();
+    while (true) {
+        auto overlap = options.overlap * tile / options.tile_size;
+        xs = tile_origins(frame_size.width, tile, overlap);
+        ys = tile_origins(frame_size.height, tile, overlap);
+        if (static_cast<int>(xs.size() * ys.size()) <= options.max_tiles ||
+            (tile >= frame_size.width && tile >= frame_size.height)) {
+            break;
+        }
+        tile = tile * 5 / 4;
+    }
+
+    for (auto y : ys) {
+        for (auto x : xs) {
+            tiles.push_back(cv::Rect(x, y, tile, tile) & cv::Rect(cv::Point(), frame_size));
+        }
+    }
+    if (options.global_view) {
+        tiles.push_back(cv::Rect(cv::Point(), frame_size));
+    }
+    tile_detections.assign(tiles.size(), std::vector<Detection>());
+    reports.assign(tiles.size(), TileReport());
+    accumulated.assign(tiles.size(), TileReport());
+    tiled_frames = 0;
+
+    logger.info("[TiledDetector][INFO] " + std::to_string(frame_size.width) + "x" + std::to_string(frame_size.height) +
+                " frame split into " + std::to_string(xs.size()) + "x" + std::to_string(ys.size()) + " tiles of " +
+                std::to_string(tile) + " px" + (options.global_view ? " + global view" : ""));
+}
+
+void TiledDetector::detect(const cv::Mat& image, std::vector<Detection>& detections) {
+    detections.clear();
+    if (image.empty()) {
+        return;
+    }
+    // Whole frame on one model, even if a swap lands while the tiles run
+    auto model = models->acquire();
+    if (tile_size_from_model && model->get_input_width() != options.tile_size) {
+        set_tile_size(model->get_input_width());
+    }
+    if (image.size() != tiles_frame_size) {
+        build_tiles(image.size());
+    }
+
+    // 1. One task per tile; ROI views, no copies
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        pool->submit([this, i, &image, &model](int worker_id) {
+            auto start = std::chrono::steady_clock::now();
+            auto& workspace = *workspaces[worker_id];
+            auto& report = reports[i];
+            report.region = tiles[i];
+            try {
+                workspace.detect(*model, image(tiles[i]), tile_detections[i]);
+                report.timings = workspace.get_last_timings();
+            } catch (const std::exception& e) {
+                tile_detections[i].clear();
+                logger.error("[TiledDetector][ERROR] Tile " + std::to_string(i) + " failed: " + std::string(e.what()));
+            }
+            report.detections = tile_detections[i].size();
+            report.total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        });
+    }
+    pool->wait_idle();
+
+    ++tiled_frames;
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        auto& sum = accumulated[i];
+        sum.region = tiles[i];
+        sum.total_ms += reports[i].total_ms;
+        sum.timings.preprocess_ms += reports[i].timings.preprocess_ms;
+        sum.timings.inference_ms += reports[i].timings.inference_ms;
+        sum.timings.postprocess_ms += reports[i].timings.postprocess_ms;
+        sum.detections += reports[i].detections;
+    }
+
+    // 2. Back to frame coordinates, then merge duplicates along the seams
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        for (auto det : tile_detections[i]) {
+            det.translate(static_cast<float>(tiles[i].x), static_cast<float>(tiles[i].y));
+            detections.push_back(det);
+        }
+    }
+    merger.class_aware_nms(detections, options.merge_iou_threshold);
+}
+
+
+std::vector<TileReport> TiledDetector::get_average_reports() const {
+    auto averages = accumulated;
+    auto frames = static_cast<double>(std::max<uint64_t>(1, tiled_frames));
+    for (auto& report : averages) {
+        report.total_ms /= frames;
+        report.timings.preprocess_ms /= frames;
+        report.timings.inference_ms /= frames;
+        report.timings.postprocess_ms /= frames;
+    }
+    return averages;
+}
\ No newline at end of file
@@ -21,37 +21,27 @@ cv::Point WindowsGraphicsCapture::get_screen_center() const {
     return cv::Point(screen_size.width / 2, screen_size.height / 2);
 }
 
-cv::Rect WindowsGraphicsCapture::calculate_fov_region(int fov_width, int fov_height) {
-    auto center = get_screen_center();
-    auto x = center.x - fov_width / 2;
-    auto y = center.y - fov_height / 2;
-    
-    // Ensure FOV doesn't go outside screen bounds
-    x = (x > 0) ? x : 0;
-    y = (y > 0) ? y : 0;
-    
-    auto actual_width = (fov_width < (screen_size.width - x)) ? fov_width : (screen_size.width - x);
-    auto actual_height = (fov_height < (screen_size.height - y)) ? fov_height : (screen_size.height - y);
-    
-    return cv::Rect(x, y, actual_width, actual_height);
-}
-
 cv::Mat WindowsGraphicsCapture::capture_fov(int fov_width, int fov_height) {
-    auto full_screen = capture_screen();
-    if (full_screen.empty()) {
+    auto frame = Frame();
+    if (!grab(centered_region(fov_width, fov_height), frame)) {
         return cv::Mat();
     }
-    
-    auto fov_region = calculate_fov_region(fov_width, fov_height);
-    return full_screen(fov_region);
+    auto fov_bgr = cv::Mat();
+    cv::cvtColor(frame.image, fov_bgr, cv::COLOR_BGRA2BGR);
+    return fov_bgr;
 }
 
 cv::Mat WindowsGraphicsCapture::capture_screen() {
-    if (!initialized) {
-        logger.error("[WGC][ERROR] Screen capture not initialized!");
+    auto frame = Frame();
+    if (!grab(cv::Rect(), frame)) {
         return cv::Mat();
     }
-    
+    auto frame_bgr = cv::Mat();
+    cv::cvtColor(frame.image, frame_bgr, cv::COLOR_BGRA2BGR);
+    return frame_bgr;
+}
+
+bool WindowsGraphicsCapture::acquire_desktop_texture(ID3D11Texture2D** desktop_texture) {
     auto desktop_resource = static_cast<IDXGIResource*>(nullptr);
     auto frame_info = DXGI_OUTDUPL_FRAME_INFO();
     
@@ -76,81 +66,115 @@ cv::Mat WindowsGraphicsCapture::capture_screen() {
                 continue; // Try again with new duplication
             } else {
                 logger.error("[WGC][ERROR] Failed to reinitialize desktop duplication");
-                return cv::Mat();
+                return false;
             }
         }
         
         // For other errors, log and return
         logger.error("[WGC][ERROR] Failed to acquire next frame: " + std::to_string(hr));
-        return cv::Mat();
+        return false;
     }
     
     if (FAILED(hr)) {
         logger.error("[WGC][ERROR] Failed to acquire next frame after retries: " + std::to_string(hr));
-        return cv::Mat();
+        return false;
     }
     
-    ID3D11Texture2D* desktop_texture = nullptr;
-    hr = desktop_resource->QueryInterface(IID_ID3D11Texture2D_, (void**)&desktop_texture);
+    hr = desktop_resource->QueryInterface(IID_ID3D11Texture2D_, (void**)desktop_texture);
     desktop_resource->Release();
     
     if (FAILED(hr)) {
         desktop_duplication->ReleaseFrame();
         logger.error("[WGC][ERROR] Failed to get ID3D11Texture2D interface: " + std::to_string(hr));
-        return cv::Mat();
+        return false;
     }
-    
-    // Get texture description
-    D3D11_TEXTURE2D_DESC texture_desc;
-    desktop_texture->GetDesc(&texture_desc);
-    
-    // Update screen size if not set
-    if (screen_size.width == 0 || screen_size.height == 0) {
-        screen_size = cv::Size(texture_desc.Width, texture_desc.Height);
-        logger.info("[WGC][INFO] Screen size detected: " + std::to_string(screen_size.width) + "x" + std::to_string(screen_size.height));
+    return true;
+}
+
+bool WindowsGraphicsCapture::ensure_staging_texture(const cv::Size& size, DXGI_FORMAT format) {
+    if (staging_texture && staging_size == size && staging_format == format) {
+        return true;
+    }
+    if (staging_texture) {
+        staging_texture->Release();
+        staging_texture = nullptr;
     }
     
-    // Create staging texture for CPU access
-    D3D11_TEXTURE2D_DESC staging_desc = texture_desc;
+    // Staging texture only as large as the region, reused across frames
+    D3D11_TEXTURE2D_DESC staging_desc = {};
+    staging_desc.Width = size.width;
+    staging_desc.Height = size.height;
+    staging_desc.MipLevels = 1;
+    staging_desc.ArraySize = 1;
+    staging_desc.Format = format;
+    staging_desc.SampleDesc.Count = 1;
     staging_desc.Usage = D3D11_USAGE_STAGING;
     staging_desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
-    staging_desc.BindFlags = 0;
-    staging_desc.MiscFlags = 0;
     
-    ID3D11Texture2D* staging_texture = nullptr;
-    hr = d3d_device->CreateTexture2D(&staging_desc, nullptr, &staging_texture);
+    auto hr = d3d_device->CreateTexture2D(&staging_desc, nullptr, &staging_texture);
+    if (FAILED(hr)) {
+        logger.error("[WGC][ERROR] Failed to create staging texture: " + std::to_string(hr));
+        staging_texture = nullptr;
+        return false;
+    }
+    staging_size = size;
+    staging_format = format;
+    return true;
+}
+
+bool WindowsGraphicsCapture::grab(const cv::Rect& region, Frame& frame) {
+    if (!initialized) {
+        logger.error("[WGC][ERROR] Screen capture not initialized!");
+        return false;
+    }
+    
+    ID3D11Texture2D* desktop_texture = nullptr;
+    if (!acquire_desktop_texture(&desktop_texture)) {
+        return false;
+    }
     
-    if (SUCCEEDED(hr)) {
-        // Copy desktop texture to staging texture
-        d3d_context->CopyResource(staging_texture, desktop_texture);
-        
-        // Map staging texture to get pixel data
-        D3D11_MAPPED_SUBRESOURCE mapped_resource;
-        hr = d3d_context->Map(staging_texture, 0, D3D11_MAP_READ, 0, &mapped_resource);
-        
-        if (SUCCEEDED(hr)) {
-            // Create OpenCV Mat from pixel data
-            cv::Mat frame(texture_desc.Height, texture_desc.Width, CV_8UC4, mapped_resource.pData, mapped_resource.RowPitch);
-            cv::Mat frame_bgr;
-            cv::cvtColor(frame, frame_bgr, cv::COLOR_BGRA2BGR);
-            
-            d3d_context->Unmap(staging_texture, 0);
-            staging_texture->Release();
-            desktop_texture->Release();
-            desktop_duplication->ReleaseFrame();
-            
-            if (frame_bgr.empty()) {
-                logger.error("[WGC][ERROR] Failed to convert captured frame!");
-            }
-            return frame_bgr;
-        }
-        
-        staging_texture->Release();
+    // Get texture description
+    D3D11_TEXTURE2D_DESC texture_desc;
+    desktop_texture->GetDesc(&texture_desc);
+    screen_size = cv::Size(texture_desc.Width, texture_desc.Height);
+    
+    auto roi = clamp_region(region);
+    if (roi.empty() || !ensure_staging_texture(roi.size(), texture_desc.Format)) {
+        desktop_texture->Release();
+        desktop_duplication->ReleaseFrame();
+        logger.error("[WGC][ERROR] Invalid capture region");
+        return false;
     }
     
+    // Copy only the requested region on the GPU, no full-desktop readback or color conversion
+    D3D11_BOX box = {};
+    box.left = roi.x;
+    box.top = roi.y;
+    box.front = 0;
+    box.right = roi.x + roi.width;
+    box.bottom = roi.y + roi.height;
+    box.back = 1;
+    d3d_context->CopySubresourceRegion(staging_texture, 0, 0, 0, 0, desktop_texture, 0, &box);
     desktop_texture->Release();
     desktop_duplication->ReleaseFrame();
-    return cv::Mat();
+    
+    D3D11_MAPPED_SUBRESOURCE mapped_resource;
+    auto hr = d3d_context->Map(staging_texture, 0, D3D11_MAP_READ, 0, &mapped_resource);
+    if (FAILED(hr)) {
+        logger.error("[WGC][ERROR] Failed to map staging texture: " + std::to_string(hr));
+        return false;
+    }
+    
+    // Desktop duplication delivers B8G8R8A8; keep it native
+    auto mapped = cv::Mat(roi.height, roi.width, CV_8UC4, mapped_resource.pData, mapped_resource.RowPitch);
+    mapped.copyTo(frame.image);
+    d3d_context->Unmap(staging_texture, 0);
+    
+    frame.format = PixelFormat::BGRA;
+    frame.region = roi;
+    frame.frame_id = frame_counter++;
+    frame.timestamp_us = now_us();
+    return true;
 }
 
 bool WindowsGraphicsCapture::initialize_d3d() {
@@ -209,6 +233,11 @@ bool WindowsGraphicsCapture::initialize_d3d() {
         return false;
     }
     
+    // Screen size is known as soon as duplication exists, before the first frame
+    auto duplication_desc = DXGI_OUTDUPL_DESC();
+    desktop_duplication->GetDesc(&duplication_desc);
+    screen_size = cv::Size(duplication_desc.ModeDesc.Width, duplication_desc.ModeDesc.Height);
+    
     initialized = true;
     
     // Check if we have proper permissions
@@ -223,6 +252,11 @@ bool WindowsGraphicsCapture::initialize_d3d() {
 }
 
 void WindowsGraphicsCapture::cleanup() {
+    if (staging_texture) {
+        staging_texture->Release();
+        staging_texture = nullptr;
+        staging_size = cv::Size();
+    }
     if (desktop_duplication) {
         desktop_duplication->Release();
         desktop_duplication = nullptr;
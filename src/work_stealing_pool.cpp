@@ -0,0 +1,103 @@
+#include "work_stealing_pool.hpp"
+#include <algorithm>
+
+thread_local const WorkStealingPool* WorkStealingPool::current_pool = nullptr;
+thread_local int WorkStealingPool::current_worker = -1;
+
+WorkStealingPool::WorkStealingPool(int num_workers) {
+    num_workers = std::max(1, num_workers);
+    for (int i = 0; i < num_workers; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (int i = 0; i < num_workers; ++i) {
+        workers.emplace_back(&WorkStealingPool::worker_loop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    auto queue_index = current_pool == this ? static_cast<size_t>(current_worker)
+                                           : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(queues[queue_index]->mutex);
+        queues[queue_index]->tasks.push_back(std::move(task));
+    }
+    // Take the wait mutex so a worker going to sleep cannot miss the wakeup
+    { std::lock_guard<std::mutex> lock(wait_mutex); }
+    work_available.notify_one();
+}
+
+void WorkStealingPool::wait_idle() {
+    std::unique_lock<std::mutex> lock(wait_mutex);
+    idle.wait(lock, [this] { return pending.load() == 0; });
+}
+
+bool WorkStealingPool::pop_local(int worker_id, Task& task) {
+    auto& queue = *queues[worker_id];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(int worker_id, Task& task) {
+    auto count = queues.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        auto& victim = *queues[(worker_id + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::worker_loop(int worker_id) {
+    current_pool = this;
+    current_worker = worker_id;
+    while (true) {
+        auto task = Task();
+        if (pop_local(worker_id, task) || steal(worker_id, task)) {
+            task(worker_id);
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(wait_mutex);
+                idle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        if (stopping) {
+            return;
+        }
+        // Re-check under the lock: submit() notifies while holding it
+        auto has_work = false;
+        for (auto& queue : queues) {
+            std::lock_guard<std::mutex> queue_lock(queue->mutex);
+            if (!queue->tasks.empty()) {
+                has_work = true;
+                break;
+            }
+        }
+        if (!has_work) {
+            work_available.wait(lock);
+        }
+    }
+}
@@ -1,29 +1,242 @@
 #include "yolov8_detector.hpp"
+#include "metrics.hpp"
+#include <algorithm>
+#include <future>
 
-YOLOv8::YOLOv8(const std::string& model_path, float conf_thres, float iou_thres) {
-    // Initialize all components
-    model = std::make_unique<YOLOv8Model>(model_path, conf_thres, iou_thres);
-    preprocessor = std::make_unique<YOLOv8Preprocessor>(model->get_input_width(), model->get_input_height());
-    postprocessor = std::make_unique<YOLOv8Postprocessor>(model->get_conf_threshold(), model->get_iou_threshold(), 
-                                                         model->get_input_width(), model->get_input_height());
-    visualizer = std::make_unique<YOLOv8Visualizer>("blood.cfg");
+YOLOv8::YOLOv8(const std::string& model_path, float conf_thres, float iou_thres) : config("blood.cfg") {
+    initialize(model_path, conf_thres, iou_thres, nullptr);
+}
+
+YOLOv8::YOLOv8(const std::string& model_path, ConfigManager& shared_config, float conf_thres, float iou_thres,
+               StartupProfile* startup)
+    : config(shared_config) {
+    initialize(model_path, conf_thres, iou_thres, startup);
+}
+
+YOLOv8::~YOLOv8() {
+    // Async workers hold the slot: stop them before a pending load or release is waited on
+    async_detector.reset();
+    if (pending_model.valid()) {
+        pending_model.wait();
+    }
+}
+
+void YOLOv8::initialize(const std::string& model_path, float conf_thres, float iou_thres, StartupProfile* startup) {
+    conf_threshold = conf_thres;
+    iou_threshold = iou_thres;
+    auto warmup_iterations = YOLOv8Model::warmup_iterations_from_config(config);
+
+    // 1. Gate session is independent of the full model: load and warm it up on its own thread
+    auto cascade_options = CascadeGate::options_from_config(config);
+    auto cascade_init = std::future<std::unique_ptr<CascadeGate>>();
+    if (cascade_options.enabled) {
+        cascade_init = std::async(std::launch::async, [cascade_options, warmup_iterations, startup] {
+            auto start = StartupProfile::Clock::now();
+            auto gate = std::make_unique<CascadeGate>(cascade_options);
+            gate->warmup(warmup_iterations);
+            if (startup) startup->record("gate", start);
+            return gate;
+        });
+    }
+
+    // 2. Full model session and warmup
+    auto step_start = StartupProfile::Clock::now();
+    auto model = std::make_shared<YOLOv8Model>(model_path, config, conf_thres, iou_thres);
+    models = std::make_shared<ModelSlot>(model);
+    swap_stats.model_path = model_path;
+    if (startup) startup->record("session", step_start);
+    step_start = StartupProfile::Clock::now();
+    model->warmup(warmup_iterations);
+    if (startup) startup->record("warmup", step_start);
+
+    // 3. Remaining components
+    step_start = StartupProfile::Clock::now();
+    workspace = std::make_unique<DetectionWorkspace>(*model, config);
+    visualizer = std::make_unique<YOLOv8Visualizer>(config);
     fov_processor = std::make_unique<FOVProcessor>(400, 400);
+
+    auto tiling_options = TiledDetector::options_from_config(config);
+    if (tiling_options.enabled) {
+        tiled_detector = std::make_unique<TiledDetector>(models, config, tiling_options);
+    }
+    auto change_options = FrameChangeDetector::options_from_config(config);
+    if (change_options.enabled) {
+        change_detector = std::make_unique<FrameChangeDetector>(change_options);
+    }
+    if (startup) startup->record("components", step_start);
+
+    if (cascade_init.valid()) {
+        cascade = cascade_init.get();
+    }
 }
 
-std::vector<Detection> YOLOv8::detect_objects(const cv::Mat& image) {
-    // 1. Preprocess image
-    auto input_tensor = preprocessor->prepare_input(image);
-    
-    // 2. Run inference
-    auto outputs = model->run_inference(input_tensor);
-    
-    // 3. Postprocess results
-    auto detections = postprocessor->process_output(outputs, image.size());
-    
-    return detections;
+Span<const Detection> YOLOv8::detect_objects(const cv::Mat& image) {
+    auto& metrics = detection_metrics();
+    auto start = std::chrono::steady_clock::now();
+    metrics.frames_in.add();
+    if (swap_ready.load(std::memory_order_acquire)) {
+        apply_pending_swap();
+    }
+
+    // Unchanged frame: answer with the previous result, no inference
+    if (change_detector && change_detector->can_reuse(image)) {
+        last_timings = DetectionTimings();
+        metrics.frames_reused.add();
+        metrics.frames_out.add();
+        return results.view().detections;
+    }
+    results.fov().clear();
+    run_detection(image, results.detections());
+    if (change_detector) {
+        change_detector->commit();
+    }
+    metrics.detect_latency.observe_ms(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    metrics.frames_out.add();
+    return results.view().detections;
+}
+
+void YOLOv8::run_detection(const cv::Mat& image, std::vector<Detection>& detections) {
+    if (!cascade) {
+        run_full_model(image, detections);
+        return;
+    }
+
+    // Cascade: the gate decides whether the full model runs on this frame
+    auto gate_start = std::chrono::steady_clock::now();
+    auto decision = cascade->evaluate(image);
+    auto gate_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - gate_start).count();
+    detection_metrics().gate_latency.observe_ms(gate_ms);
+    if (!decision.run_full) {
+        detection_metrics().frames_gated.add();
+        last_timings = DetectionTimings();
+        last_timings.gate_ms = gate_ms;
+        detections.clear();
+        return;
+    }
+
+    run_full_model(image, detections);
+    cascade->record(decision, detections.size());
+    last_timings.gate_ms = gate_ms;
+}
+
+void YOLOv8::run_full_model(const cv::Mat& image, std::vector<Detection>& detections) {
+    if (!tiled_detector || !tiled_detector->should_tile(image.size())) {
+        auto model = models->acquire();
+        workspace->detect(*model, image, detections);
+        last_timings = workspace->get_last_timings();
+        return;
+    }
+
+    // Tiled: stage timings are summed over the tiles (CPU time, not latency)
+    tiled_detector->detect(image, detections);
+    last_timings = DetectionTimings();
+    for (const auto& report : tiled_detector->get_last_reports()) {
+        last_timings.preprocess_ms += report.timings.preprocess_ms;
+        last_timings.inference_ms += report.timings.inference_ms;
+        last_timings.postprocess_ms += report.timings.postprocess_ms;
+    }
+}
+
+const DetectionTimings& YOLOv8::get_last_timings() const {
+    return last_timings;
+}
+
+AsyncDetector& YOLOv8::get_async_detector() {
+    std::call_once(async_init, [this] {
+        async_detector = std::make_unique<AsyncDetector>(models, config, AsyncDetector::options_from_config(config));
+    });
+    return *async_detector;
+}
+
+std::future<DetectionResult> YOLOv8::detect_async(const cv::Mat& image) {
+    if (swap_ready.load(std::memory_order_acquire)) {
+        apply_pending_swap();
+    }
+    return get_async_detector().submit(image);
+}
+
+void YOLOv8::detect_async(const cv::Mat& image, AsyncDetector::Callback callback) {
+    if (swap_ready.load(std::memory_order_acquire)) {
+        apply_pending_swap();
+    }
+    get_async_detector().submit(image, std::move(callback));
+}
+
+bool YOLOv8::request_model_swap(const std::string& model_path) {
+    auto lock = std::lock_guard<std::mutex>(swap_mutex);
+    if (pending_model.valid()) {
+        logger.warning("[YOLOv8][WARNING] Model swap to " + pending_model_path + " still in progress, ignoring " + model_path);
+        return false;
+    }
+    logger.info("[YOLOv8][INFO] Loading replacement model " + model_path + " in the background");
+    pending_model_path = model_path;
+    pending_since = std::chrono::steady_clock::now();
+    pending_model = std::async(std::launch::async, [this, model_path] {
+        auto replacement = std::shared_ptr<YOLOv8Model>();
+        try {
+            // The rollout may also change [Model] backend, thresholds or input size in the file;
+            // command line overrides still win
+            auto swap_config = config.reloaded();
+            replacement = std::make_shared<YOLOv8Model>(model_path, swap_config, conf_threshold, iou_threshold);
+            replacement->warmup(YOLOv8Model::warmup_iterations_from_config(swap_config));
+        } catch (const std::exception& e) {
+            logger.error("[YOLOv8][ERROR] Replacement model " + model_path + " failed to load, keeping the current one: " +
+                         std::string(e.what()));
+            replacement.reset();
+        }
+        swap_ready.store(true, std::memory_order_release);
+        return replacement;
+    });
+    return true;
+}
+
+void YOLOv8::apply_pending_swap() {
+    auto lock = std::lock_guard<std::mutex>(swap_mutex);
+    if (!swap_ready.load(std::memory_order_acquire) || !pending_model.valid()) {
+        return;
+    }
+    swap_ready.store(false, std::memory_order_relaxed);
+    auto replacement = pending_model.get();
+    auto load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pending_since).count();
+    if (!replacement) {
+        ++swap_stats.failures;
+        detection_metrics().model_swap_failures.add();
+        return;
+    }
+
+    // 1. Publish: frames starting from now run on the replacement
+    auto previous = models->exchange(replacement);
+    if (change_detector) {
+        change_detector->reset();
+    }
+    ++swap_stats.swaps;
+    detection_metrics().model_swaps.add();
+    swap_stats.last_load_ms = load_ms;
+    swap_stats.model_path = pending_model_path;
+    logger.info("[YOLOv8][INFO] Swapped to " + pending_model_path + " (" + replacement->get_backend_name() + ", " +
+                std::to_string(replacement->get_input_width()) + "x" + std::to_string(replacement->get_input_height()) +
+                ") after " + std::to_string(static_cast<int>(load_ms)) + " ms of background loading");
+
+    // 2. In-flight frames keep the old session alive; our reference is dropped off the frame path
+    retired_releases.erase(std::remove_if(retired_releases.begin(), retired_releases.end(), [](std::future<void>& release) {
+        return release.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), retired_releases.end());
+    retired_releases.push_back(std::async(std::launch::async, [previous = std::move(previous)]() mutable {
+        previous.reset();
+    }));
+}
+
+bool YOLOv8::is_swap_pending() {
+    auto lock = std::lock_guard<std::mutex>(swap_mutex);
+    return pending_model.valid();
+}
+
+ModelSwapStats YOLOv8::get_swap_stats() {
+    auto lock = std::lock_guard<std::mutex>(swap_mutex);
+    return swap_stats;
 }
 
-cv::Mat YOLOv8::draw_detections(const cv::Mat& image, const std::vector<Detection>& detections) {
+cv::Mat YOLOv8::draw_detections(const cv::Mat& image, Span<const Detection> detections) {
     return visualizer->draw_detections(image, detections);
 }
 
@@ -35,19 +248,20 @@ cv::Size YOLOv8::get_fov_size() const {
     return fov_processor->get_fov_size();
 }
 
-std::vector<Detection> YOLOv8::detect_objects_fov(const cv::Mat& fov_image) {
+FrameDetections YOLOv8::detect_objects_fov(const cv::Mat& fov_image) {
     if (fov_image.empty()) {
-        return std::vector<Detection>();
+        return FrameDetections();
     }
     
     // Detect objects in FOV
     auto detections = detect_objects(fov_image);
     
-    // Process FOV-specific calculations
-    return fov_processor->process_fov_detections(detections);
+    // FOV metrics into the arena, next to the detections they describe
+    fov_processor->compute_metrics(detections, results.fov());
+    return results.view();
 }
 
-cv::Mat YOLOv8::draw_fov_detections(const cv::Mat& fov_image, const std::vector<Detection>& detections) {
+cv::Mat YOLOv8::draw_fov_detections(const cv::Mat& fov_image, const FrameDetections& detections) {
     auto fov_size = fov_processor->get_fov_size();
     return visualizer->draw_fov_detections(fov_image, detections, fov_size.width, fov_size.height);
 } 
\ No newline at end of file
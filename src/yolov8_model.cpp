@@ -1,129 +1,117 @@
 #include "yolov8_model.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 
-YOLOv8Model::YOLOv8Model(const std::string& model_path, float conf_thres, float iou_thres) 
-    : conf_threshold(conf_thres), iou_threshold(iou_thres), config("blood.cfg") {
+YOLOv8Model::YOLOv8Model(const std::string& model_path, float conf_thres, float iou_thres, int intra_threads) 
+    : conf_threshold(conf_thres), iou_threshold(iou_thres), intra_op_threads(intra_threads) {
     
     // Load configuration from file
-    load_config_from_file();
+    auto config = ConfigManager("blood.cfg");
+    load_config_from_file(config);
     
     initialize_model(model_path);
 }
 
-void YOLOv8Model::load_config_from_file() {
+YOLOv8Model::YOLOv8Model(const std::string& model_path, ConfigManager& config, float conf_thres, float iou_thres, int intra_threads)
+    : conf_threshold(conf_thres), iou_threshold(iou_thres), intra_op_threads(intra_threads) {
+    load_config_from_file(config);
+    initialize_model(model_path);
+}
+
+void YOLOv8Model::load_config_from_file(ConfigManager& config) {
     // Carregar parâmetros do modelo
     input_width = config.get_int("Model", "input_width", 640);
     input_height = config.get_int("Model", "input_height", 640);
     conf_threshold = config.get_float("Model", "conf_threshold", 0.3f);
     iou_threshold = config.get_float("Model", "iou_threshold", 0.5f);
+    backend_kind = config.get_string("Model", "backend", backend_kind);
+    if (intra_op_threads <= 0) {
+        intra_op_threads = config.get_int("Model", "intra_op_threads", 0);
+    }
+    memory_options = memory_options_from_config(config);
     
     // Log de todas as configurações
     config.log_config();
 }
 
 void YOLOv8Model::initialize_model(const std::string& model_path) {
-    try {
-        env = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "YOLOv8");
-        
-        auto session_options = Ort::SessionOptions();
-        session_options.SetIntraOpNumThreads(1);
-        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-        
-        // CPU Optimization for AMD RX 7600 XT
-        // Using CPU with maximum optimizations for high FPS
-        session_options.SetIntraOpNumThreads(8); // Use more CPU threads
-        session_options.SetInterOpNumThreads(4); // Parallel execution
-        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-        
-        logger.info("[YOLOv8Model][INFO] CPU optimization enabled for high FPS");
-        logger.info("[YOLOv8Model][INFO] Using 8 threads for maximum performance");
-        
-        // Fix: use wstring for model path
-        auto wmodel_path = std::wstring(model_path.begin(), model_path.end());
-        session = Ort::Session(env, wmodel_path.c_str(), session_options);
-        
-        // Get input and output names (fixed for new API)
-        auto allocator = Ort::AllocatorWithDefaultOptions();
-        
-        // Get input names
-        auto num_inputs = session.GetInputCount();
-        
-        for (size_t i = 0; i < num_inputs; ++i) {
-            auto input_name_alloc = session.GetInputNameAllocated(i, allocator);
-            auto input_name = input_name_alloc.get();
-            input_names.push_back(input_name);
-        }
-        
-        // Get output names
-        auto num_outputs = session.GetOutputCount();
-        
-        for (size_t i = 0; i < num_outputs; ++i) {
-            auto output_name_alloc = session.GetOutputNameAllocated(i, allocator);
-            auto output_name = output_name_alloc.get();
-            output_names.push_back(output_name);
-        }
-        
-        // Log detailed input of the model (equal to Python)
-        for (size_t i = 0; i < num_inputs; ++i) {
-            auto input_name_alloc = session.GetInputNameAllocated(i, allocator);
-            auto input_name = input_name_alloc.get();
-            
-            auto type_info = session.GetInputTypeInfo(i);
-            auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
-            auto type = tensor_info.GetElementType();
-            auto input_dims = tensor_info.GetShape();
-            
-            auto type_str = std::string();
-            switch (type) {
-                case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: type_str = "float32"; break;
-                case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: type_str = "uint8"; break;
-                case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8: type_str = "int8"; break;
-                default: type_str = "unknown"; break;
-            }
-            
-            auto dims_str = std::string();
-            for (size_t j = 0; j < input_dims.size(); ++j) {
-                dims_str += std::to_string(input_dims[j]);
-                if (j + 1 < input_dims.size()) dims_str += ", ";
-            }
-        }
-        
-    } catch (const std::exception& e) {
-        logger.error("[YOLOv8Model][ERROR] Failed to initialize model: " + std::string(e.what()));
-        throw;
+    static auto next_instance_id = std::atomic<uint64_t>(1);
+    instance_id = next_instance_id.fetch_add(1);
+    
+    auto options = BackendOptions();
+    options.input_width = input_width;
+    options.input_height = input_height;
+    options.intra_op_threads = intra_op_threads > 0 ? intra_op_threads : 8;
+    options.memory = memory_options;
+    backend = create_inference_backend(backend_kind, model_path, options);
+    
+    // The backend may override [Model] input size with a static model shape
+    input_width = backend->input_width();
+    input_height = backend->input_height();
+    logger.info("[YOLOv8Model][INFO] Backend: " + std::string(backend->name()) + ", input " +
+                std::to_string(input_width) + "x" + std::to_string(input_height));
+}
+
+InferenceOutput YOLOv8Model::run_inference(const std::vector<float>& input_tensor) {
+    if (input_tensor.size() != static_cast<size_t>(input_width) * input_height * 3) {
+        logger.error("[YOLOv8Model][ERROR] Float input must be a 3x" + std::to_string(input_height) + "x" +
+                     std::to_string(input_width) + " tensor");
+        throw std::runtime_error("Invalid float input tensor");
     }
+    return backend->run(input_tensor);
 }
 
-std::vector<Ort::Value> YOLOv8Model::run_inference(const std::vector<float>& input_tensor) {
+InferenceOutput YOLOv8Model::run_inference(const cv::Mat& input_image) {
+    if (input_image.type() != CV_8UC3 || !input_image.isContinuous() ||
+        input_image.cols != input_width || input_image.rows != input_height) {
+        logger.error("[YOLOv8Model][ERROR] uint8 input must be a continuous " +
+                     std::to_string(input_width) + "x" + std::to_string(input_height) + " BGR image");
+        throw std::runtime_error("Invalid uint8 input image");
+    }
+    return backend->run(input_image);
+}
+
+int YOLOv8Model::warmup_iterations_from_config(ConfigManager& config) {
+    if (config.get_string("Performance", "enable_model_warmup", "true") != "true") {
+        return 0;
+    }
+    return std::max(0, config.get_int("Performance", "warmup_iterations", 10));
+}
+
+SessionMemoryOptions YOLOv8Model::memory_options_from_config(ConfigManager& config) {
+    auto result = SessionMemoryOptions();
+    result.share_weights = config.get_string("Memory", "share_weights", "true") == "true";
+    result.layout_optimization = config.get_string("Memory", "layout_optimization", "true") == "true";
+    result.shared_arena = config.get_string("Memory", "shared_arena", "false") == "true";
+    result.arena_extend_strategy = config.get_string("Memory", "arena_extend_strategy", "next_power_of_two") == "same_as_requested" ? 1 : 0;
+    result.arena_max_bytes = static_cast<size_t>(std::max(0, config.get_int("Memory", "arena_max_mb", 0))) * 1024 * 1024;
+    auto initial_chunk_kb = config.get_int("Memory", "arena_initial_chunk_kb", 0);
+    result.arena_initial_chunk_bytes = initial_chunk_kb > 0 ? initial_chunk_kb * 1024 : -1;
+    return result;
+}
+
+double YOLOv8Model::warmup(int iterations) {
+    auto start = std::chrono::steady_clock::now();
+    if (iterations <= 0) {
+        return 0.0;
+    }
     try {
-        if (input_names.empty() || output_names.empty()) {
-            logger.error("[YOLOv8Model][ERROR] Input or output names are empty!");
-            throw std::runtime_error("Input or output names are empty");
-        }
-        auto input_names_char = std::vector<const char*>(input_names.size());
-        auto output_names_char = std::vector<const char*>(output_names.size());
-        for (size_t i = 0; i < input_names.size(); ++i) {
-            input_names_char[i] = input_names[i].c_str();
-        }
-        for (size_t i = 0; i < output_names.size(); ++i) {
-            output_names_char[i] = output_names[i].c_str();
-        }
-        auto input_tensors = std::vector<Ort::Value>();
-        try {
-            auto input_shape = std::vector<int64_t>{1, 3, input_height, input_width};
-            input_tensors.push_back(Ort::Value::CreateTensor<float>(
-                Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault),
-                const_cast<float*>(input_tensor.data()),
-                input_tensor.size(),
-                input_shape.data(),
-                input_shape.size()));
-        } catch (const std::exception& e) {
-            logger.error("[YOLOv8Model][ERROR] Failed to create input tensor: " + std::string(e.what()));
-            throw;
+        if (has_uint8_input()) {
+            auto blank = cv::Mat(input_height, input_width, CV_8UC3, cv::Scalar::all(114));
+            for (int i = 0; i < iterations; ++i) {
+                run_inference(blank);
+            }
+        } else {
+            auto blank = std::vector<float>(static_cast<size_t>(input_width) * input_height * 3, 114.0f / 255.0f);
+            for (int i = 0; i < iterations; ++i) {
+                run_inference(blank);
+            }
         }
-        auto result = session.Run(Ort::RunOptions{nullptr}, input_names_char.data(), input_tensors.data(), input_tensors.size(), output_names_char.data(), output_names_char.size());
-        return result;
     } catch (const std::exception& e) {
-        logger.error("[YOLOv8Model][ERROR] Failed to execute inference: " + std::string(e.what()));
-        throw;
+        logger.warning("[YOLOv8Model][WARNING] Warmup failed: " + std::string(e.what()));
     }
-} 
\ No newline at end of file
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    logger.info("[YOLOv8Model][INFO] Warmup: " + std::to_string(iterations) + " runs in " + std::to_string(static_cast<int>(ms)) + " ms");
+    return ms;
+}
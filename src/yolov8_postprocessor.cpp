@@ -1,4 +1,5 @@
 #include "yolov8_postprocessor.hpp"
+#include "cpu_dispatch.hpp"
 #include <algorithm>
 #include <numeric>
 
@@ -16,134 +17,76 @@ void YOLOv8Postprocessor::set_input_size(int width, int height) {
     input_height = height;
 }
 
-std::vector<Detection> YOLOv8Postprocessor::process_output(const std::vector<Ort::Value>& outputs, const cv::Size& original_size) {
-    auto detections = std::vector<Detection>();
+void YOLOv8Postprocessor::process_output(const InferenceOutput& outputs, const cv::Size& original_size,
+                                         const LetterboxInfo& letterbox, std::vector<Detection>& detections) {
+    detections.clear();
     if (outputs.empty()) {
         logger.error("[YOLOv8Postprocessor][ERROR] Model output is empty!");
-        return detections;
+        return;
     }
     
     // Get the first output tensor
     const auto& output = outputs[0];
-    auto output_shape = output.GetTensorTypeAndShapeInfo().GetShape();
+    const auto& output_shape = output.shape;
 
     // Check expected shape
     if (output_shape.size() < 2) {
         logger.error("[YOLOv8Postprocessor][ERROR] Unexpected output shape! Expected at least 2 dimensions.");
-        return detections;
+        return;
     }
     
-    auto output_data = static_cast<float*>(nullptr);
-    try {
-        output_data = const_cast<float*>(output.GetTensorData<float>());
-    } catch (const std::exception& e) {
-        logger.error(std::string("[YOLOv8Postprocessor][ERROR] Failed to access output tensor data: ") + e.what());
-        return detections;
-    }
+    auto output_data = output.data;
     if (!output_data) {
         logger.error("[YOLOv8Postprocessor][ERROR] Output tensor data pointer is null!");
-        return detections;
+        return;
+    }
+    
+    // [num_dets, 6] from a graph with embedded NMS (tools/append_nms.py): already decoded and suppressed
+    if (output_shape.size() == 2 && output_shape[1] == 6) {
+        decode_nms_output(output_data, static_cast<int>(output_shape[0]), original_size, letterbox, detections);
+        return;
     }
     
+    const auto& kernels = CpuDispatch::kernels();
+
     // Suporte ao formato [1, 5, 8400] do blood.onnx
     if (output_shape.size() == 3 && output_shape[1] == 5) {
         auto num_boxes = static_cast<int>(output_shape[2]);
-        auto img_width = original_size.width;
-        auto img_height = original_size.height;
-        auto input_w = input_width;
-        auto input_h = input_height;
 
-        for (int i = 0; i < num_boxes; ++i) {
-            float x = output_data[0 * num_boxes + i];
-            float y = output_data[1 * num_boxes + i];
-            float w = output_data[2 * num_boxes + i];
-            float h = output_data[3 * num_boxes + i];
-            float score = output_data[4 * num_boxes + i];
-
-            if (score > conf_threshold) {
-                float x_scaled = x / input_w * img_width;
-                float y_scaled = y / input_h * img_height;
-                float w_scaled = w / input_w * img_width;
-                float h_scaled = h / input_h * img_height;
-                float x1 = x_scaled - w_scaled / 2.0f;
-                float y1 = y_scaled - h_scaled / 2.0f;
-                float x2 = x_scaled + w_scaled / 2.0f;
-                float y2 = y_scaled + h_scaled / 2.0f;
-                x1 = std::max(0.0f, std::min(x1, static_cast<float>(img_width-1)));
-                y1 = std::max(0.0f, std::min(y1, static_cast<float>(img_height-1)));
-                x2 = std::max(0.0f, std::min(x2, static_cast<float>(img_width-1)));
-                y2 = std::max(0.0f, std::min(y2, static_cast<float>(img_height-1)));
-                Detection det;
-                det.box = cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2));
-                det.score = score;
-                det.class_id = 0;
-                detections.push_back(det);
-            }
+        // Score plane scanned for candidates, only those boxes are decoded
+        candidates.resize(num_boxes);
+        auto count = kernels.scan_scores(output_data + 4 * num_boxes, num_boxes, conf_threshold, candidates.data());
+        for (int k = 0; k < count; ++k) {
+            auto i = candidates[k];
+            detections.push_back(make_detection(output_data[i], output_data[num_boxes + i], output_data[2 * num_boxes + i],
+                                                output_data[3 * num_boxes + i], output_data[4 * num_boxes + i], 0,
+                                                original_size, letterbox));
         }
         // Aplica NMS e retorna
-        return non_max_suppression(detections);
+        non_max_suppression(detections);
+        return;
     }
-    // Option 2: [1, N, 4+num_classes] - default YOLOv8 format
+    // Option 2: [1, 4+num_classes, N] - default YOLOv8 format
     else if (output_shape.size() == 3) {
         int num_boxes = static_cast<int>(output_shape[2]); // 8400
-        int num_classes = static_cast<int>(output_shape[1]) - 4; // 1 (se blood.onnx for custom)
-        int img_width = original_size.width;
-        int img_height = original_size.height;
-        int input_w = input_width;
-        int input_h = input_height;
-
-        // Transpose: predictions = np.squeeze(output[0]).T
-        std::vector<float> transposed_output(num_boxes * output_shape[1]);
-        for (int i = 0; i < output_shape[1]; ++i) {
-            for (int j = 0; j < num_boxes; ++j) {
-                transposed_output[j * output_shape[1] + i] = output_data[i * num_boxes + j];
-            }
+        int num_classes = static_cast<int>(output_shape[1]) - 4;
+        if (num_classes < 1) {
+            logger.error("[YOLOv8Postprocessor][ERROR] Output has no class scores!");
+            return;
         }
 
-        // For each box
-        for (int i = 0; i < num_boxes; ++i) {
-            float* pred = transposed_output.data() + i * output_shape[1];
-            float x = pred[0];
-            float y = pred[1];
-            float w = pred[2];
-            float h = pred[3];
-            float score = pred[4];
-            int class_id = 0;
-            float max_score = score;
-            // If there is more than 1 class, get the one with the highest score
-            if (num_classes > 1) {
-                max_score = pred[4];
-                class_id = 0;
-                for (int c = 0; c < num_classes; ++c) {
-                    float s = pred[4 + c];
-                    if (s > max_score) {
-                        max_score = s;
-                        class_id = c;
-                    }
-                }
-            }
-            if (max_score > conf_threshold) {
-                // Rescale like in Python
-                float x_scaled = x / input_w * img_width;
-                float y_scaled = y / input_h * img_height;
-                float w_scaled = w / input_w * img_width;
-                float h_scaled = h / input_h * img_height;
-                // xywh2xyxy
-                float x1 = x_scaled - w_scaled / 2.0f;
-                float y1 = y_scaled - h_scaled / 2.0f;
-                float x2 = x_scaled + w_scaled / 2.0f;
-                float y2 = y_scaled + h_scaled / 2.0f;
-                // Clamp
-                x1 = std::max(0.0f, std::min(x1, static_cast<float>(img_width-1)));
-                y1 = std::max(0.0f, std::min(y1, static_cast<float>(img_height-1)));
-                x2 = std::max(0.0f, std::min(x2, static_cast<float>(img_width-1)));
-                y2 = std::max(0.0f, std::min(y2, static_cast<float>(img_height-1)));
-                Detection det;
-                det.box = cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2));
-                det.score = max_score;
-                det.class_id = class_id;
-                detections.push_back(det);
-            }
+        // Channel-major layout: best class per box straight from the class planes (no transpose),
+        // then only boxes above the threshold are decoded
+        best_scores.resize(num_boxes);
+        best_classes.resize(num_boxes);
+        candidates.resize(num_boxes);
+        kernels.class_argmax(output_data + 4 * num_boxes, num_classes, num_boxes, best_scores.data(), best_classes.data());
+        auto count = kernels.scan_scores(best_scores.data(), num_boxes, conf_threshold, candidates.data());
+        for (int k = 0; k < count; ++k) {
+            auto i = candidates[k];
+            detections.push_back(make_detection(output_data[i], output_data[num_boxes + i], output_data[2 * num_boxes + i],
+                                                output_data[3 * num_boxes + i], best_scores[i], best_classes[i],
+                                                original_size, letterbox));
         }
     }
     // Option 2: [1, num_classes, N] - transposed format
@@ -163,7 +106,7 @@ std::vector<Detection> YOLOv8Postprocessor::process_output(const std::vector<Ort
             int num_boxes = total_elements / elements_per_box;
             
             for (int i = 0; i < num_boxes; ++i) {
-                float* box_data = output_data + i * elements_per_box;
+                const float* box_data = output_data + i * elements_per_box;
                 float x = box_data[0];
                 float y = box_data[1];
                 float w = box_data[2];
@@ -190,8 +133,11 @@ std::vector<Detection> YOLOv8Postprocessor::process_output(const std::vector<Ort
                     x2 = std::max(0.0f, std::min(x2, static_cast<float>(original_size.width-1)));
                     y2 = std::max(0.0f, std::min(y2, static_cast<float>(original_size.height-1)));
                     
-                    Detection det;
-                    det.box = cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2));
+                    auto det = Detection();
+                    det.x1 = x1;
+                    det.y1 = y1;
+                    det.x2 = x2;
+                    det.y2 = y2;
                     det.score = score;
                     det.class_id = class_id;
                     detections.push_back(det);
@@ -204,46 +150,106 @@ std::vector<Detection> YOLOv8Postprocessor::process_output(const std::vector<Ort
     }
     
     // Apply NMS
-    return non_max_suppression(detections);
+    non_max_suppression(detections);
 }
 
-std::vector<Detection> YOLOv8Postprocessor::non_max_suppression(const std::vector<Detection>& detections) {
-    if (detections.empty()) return detections;
-    
-    std::vector<Detection> result;
-    std::vector<bool> used(detections.size(), false);
-    
-    // Sort by confidence
-    std::vector<size_t> indices(detections.size());
-    std::iota(indices.begin(), indices.end(), 0);
-    std::sort(indices.begin(), indices.end(), [&](size_t a, size_t b) { return detections[a].score > detections[b].score; });
+void YOLOv8Postprocessor::decode_nms_output(const float* output_data, int num_dets, const cv::Size& original_size,
+                                            const LetterboxInfo& letterbox, std::vector<Detection>& detections) {
+    detections.reserve(num_dets);
+    auto max_x = static_cast<float>(original_size.width - 1);
+    auto max_y = static_cast<float>(original_size.height - 1);
     
-    for (size_t i = 0; i < indices.size(); ++i) {
-        if (used[indices[i]]) continue;
-        result.push_back(detections[indices[i]]);
-        used[indices[i]] = true;
-        for (size_t j = i + 1; j < indices.size(); ++j) {
-            if (used[indices[j]]) continue;
-            if (calculate_iou(detections[indices[i]].box, detections[indices[j]].box) > iou_threshold) {
-                used[indices[j]] = true;
-            }
-        }
+    // Rows are [x1, y1, x2, y2, score, class_id] in model input pixels
+    for (int i = 0; i < num_dets; ++i) {
+        const float* row = output_data + i * 6;
+        if (row[4] <= conf_threshold) continue;
+        
+        auto det = Detection();
+        det.x1 = std::max(0.0f, std::min((row[0] - letterbox.pad_x) / letterbox.scale_x, max_x));
+        det.y1 = std::max(0.0f, std::min((row[1] - letterbox.pad_y) / letterbox.scale_y, max_y));
+        det.x2 = std::max(0.0f, std::min((row[2] - letterbox.pad_x) / letterbox.scale_x, max_x));
+        det.y2 = std::max(0.0f, std::min((row[3] - letterbox.pad_y) / letterbox.scale_y, max_y));
+        det.score = row[4];
+        det.class_id = static_cast<int>(row[5]);
+        detections.push_back(det);
     }
-    return result;
 }
 
-float YOLOv8Postprocessor::calculate_iou(const cv::Rect& box1, const cv::Rect& box2) {
-    int x1 = std::max(box1.x, box2.x);
-    int y1 = std::max(box1.y, box2.y);
-    int x2 = std::min(box1.x + box1.width, box2.x + box2.width);
-    int y2 = std::min(box1.y + box1.height, box2.y + box2.height);
+Detection YOLOv8Postprocessor::make_detection(float x, float y, float w, float h, float score, int class_id,
+                                              const cv::Size& original_size, const LetterboxInfo& letterbox) const {
+    // Undo letterbox: remove padding, then scale back to the original image
+    float x_scaled = (x - letterbox.pad_x) / letterbox.scale_x;
+    float y_scaled = (y - letterbox.pad_y) / letterbox.scale_y;
+    float w_scaled = w / letterbox.scale_x;
+    float h_scaled = h / letterbox.scale_y;
+    // xywh2xyxy
+    float x1 = x_scaled - w_scaled / 2.0f;
+    float y1 = y_scaled - h_scaled / 2.0f;
+    float x2 = x_scaled + w_scaled / 2.0f;
+    float y2 = y_scaled + h_scaled / 2.0f;
+    // Clamp
+    auto det = Detection();
+    det.x1 = std::max(0.0f, std::min(x1, static_cast<float>(original_size.width - 1)));
+    det.y1 = std::max(0.0f, std::min(y1, static_cast<float>(original_size.height - 1)));
+    det.x2 = std::max(0.0f, std::min(x2, static_cast<float>(original_size.width - 1)));
+    det.y2 = std::max(0.0f, std::min(y2, static_cast<float>(original_size.height - 1)));
+    det.score = score;
+    det.class_id = class_id;
+    return det;
+}
+
+void YOLOv8Postprocessor::non_max_suppression(std::vector<Detection>& detections) {
+    suppress(detections, iou_threshold, false);
+}
+
+void YOLOv8Postprocessor::class_aware_nms(std::vector<Detection>& detections, float iou_thres) {
+    suppress(detections, iou_thres, true);
+}
+
+void YOLOv8Postprocessor::suppress(std::vector<Detection>& detections, float iou_thres, bool class_aware) {
+    if (detections.empty()) return;
     
-    if (x2 <= x1 || y2 <= y1) return 0.0f;
+    // Sort by confidence
+    auto count = detections.size();
+    nms_order.resize(count);
+    std::iota(nms_order.begin(), nms_order.end(), 0);
+    std::sort(nms_order.begin(), nms_order.end(), [&](int a, int b) { return detections[a].score > detections[b].score; });
     
-    int intersection = (x2 - x1) * (y2 - y1);
-    int area1 = box1.width * box1.height;
-    int area2 = box2.width * box2.height;
-    int union_area = area1 + area2 - intersection;
+    // Boxes in score order as arrays: each kept box is tested against all later ones in one kernel call
+    nms_sorted.resize(count);
+    nms_x1.resize(count);
+    nms_y1.resize(count);
+    nms_x2.resize(count);
+    nms_y2.resize(count);
+    nms_area.resize(count);
+    nms_class.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        const auto& det = detections[nms_order[k]];
+        nms_sorted[k] = det;
+        nms_x1[k] = det.x1;
+        nms_y1[k] = det.y1;
+        nms_x2[k] = det.x2;
+        nms_y2[k] = det.y2;
+        nms_area[k] = det.area();
+        nms_class[k] = det.class_id;
+    }
+    auto boxes = BoxArrays();
+    boxes.x1 = nms_x1.data();
+    boxes.y1 = nms_y1.data();
+    boxes.x2 = nms_x2.data();
+    boxes.y2 = nms_y2.data();
+    boxes.area = nms_area.data();
+    boxes.class_id = class_aware ? nms_class.data() : nullptr;
+    suppressed.assign(count, 0);
     
-    return static_cast<float>(intersection) / union_area;
-} 
\ No newline at end of file
+    // Survivors written back over the input, in score order
+    const auto& kernels = CpuDispatch::kernels();
+    auto end = static_cast<int>(count);
+    auto kept = size_t(0);
+    for (int k = 0; k < end; ++k) {
+        if (suppressed[k]) continue;
+        detections[kept++] = nms_sorted[k];
+        kernels.suppress_overlaps(boxes, k, k + 1, end, iou_thres, suppressed.data());
+    }
+    detections.resize(kept);
+}
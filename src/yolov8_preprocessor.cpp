@@ -1,41 +1,170 @@
 #include "yolov8_preprocessor.hpp"
+#include "cpu_dispatch.hpp"
+#include <algorithm>
+#include <cmath>
 
-YOLOv8Preprocessor::YOLOv8Preprocessor(int width, int height) 
-    : input_width(width), input_height(height) {
+YOLOv8Preprocessor::YOLOv8Preprocessor(int width, int height, ResizeMode mode)
+    : input_width(width), input_height(height), resize_mode(mode) {
 }
 
 void YOLOv8Preprocessor::set_input_size(int width, int height) {
     input_width = width;
     input_height = height;
+    invalidate_tables();
 }
 
-std::vector<float> YOLOv8Preprocessor::prepare_input(const cv::Mat& image) {
+void YOLOv8Preprocessor::set_resize_mode(ResizeMode mode, int pad) {
+    resize_mode = mode;
+    pad_value = std::max(0, std::min(pad, 255));
+    invalidate_tables();
+}
+
+ResizeMode YOLOv8Preprocessor::parse_resize_mode(const std::string& value) {
+    return value == "letterbox" ? ResizeMode::Letterbox : ResizeMode::Stretch;
+}
+
+void YOLOv8Preprocessor::invalidate_tables() {
+    tables.source_size = cv::Size();
+    tables.source_channels = 0;
+}
+
+void YOLOv8Preprocessor::build_remap_tables(const cv::Size& source_size, int channels) {
+    auto& t = tables;
+    t.source_size = source_size;
+    t.source_channels = channels;
+
+    // 1. Scale and padding
+    auto scale_x = static_cast<float>(input_width) / source_size.width;
+    auto scale_y = static_cast<float>(input_height) / source_size.height;
+    auto content_width = input_width;
+    auto content_height = input_height;
+    if (resize_mode == ResizeMode::Letterbox) {
+        auto scale = std::min(scale_x, scale_y);
+        scale_x = scale_y = scale;
+        content_width = std::min(input_width, static_cast<int>(std::lround(source_size.width * scale)));
+        content_height = std::min(input_height, static_cast<int>(std::lround(source_size.height * scale)));
+    }
+    t.content = cv::Rect((input_width - content_width) / 2, (input_height - content_height) / 2, content_width, content_height);
+    t.letterbox.scale_x = scale_x;
+    t.letterbox.scale_y = scale_y;
+    t.letterbox.pad_x = t.content.x;
+    t.letterbox.pad_y = t.content.y;
+
+    // 2. Horizontal taps (pixel centers aligned like cv::resize INTER_LINEAR)
+    t.x0_offsets.resize(content_width);
+    t.x1_offsets.resize(content_width);
+    t.x_weights.resize(content_width);
+    for (int dx = 0; dx < content_width; ++dx) {
+        auto sx = std::max(0.0f, (dx + 0.5f) / scale_x - 0.5f);
+        auto x0 = std::min(static_cast<int>(sx), source_size.width - 1);
+        auto x1 = std::min(x0 + 1, source_size.width - 1);
+        t.x0_offsets[dx] = x0 * channels;
+        t.x1_offsets[dx] = x1 * channels;
+        t.x_weights[dx] = std::min(sx - x0, 1.0f);
+    }
+
+    // 3. Vertical taps
+    t.y0_rows.resize(content_height);
+    t.y1_rows.resize(content_height);
+    t.y_weights.resize(content_height);
+    for (int dy = 0; dy < content_height; ++dy) {
+        auto sy = std::max(0.0f, (dy + 0.5f) / scale_y - 0.5f);
+        auto y0 = std::min(static_cast<int>(sy), source_size.height - 1);
+        t.y0_rows[dy] = y0;
+        t.y1_rows[dy] = std::min(y0 + 1, source_size.height - 1);
+        t.y_weights[dy] = std::min(sy - y0, 1.0f);
+    }
+
+    ++t.generation;
+}
+
+bool YOLOv8Preprocessor::update_remap_tables(const cv::Mat& image) {
     if (image.empty()) {
         logger.error("[YOLOv8Preprocessor][ERROR] Input image is empty!");
-        return std::vector<float>();
-    }
-    
-    // 1. Convert BGR to RGB
-    auto rgb_img = cv::Mat();
-    cv::cvtColor(image, rgb_img, cv::COLOR_BGR2RGB);
-    
-    // 2. Resize
-    auto resized = cv::Mat();
-    cv::resize(rgb_img, resized, cv::Size(input_width, input_height));
-    
-    // 3. Normalize to [0,1]
-    auto float_img = cv::Mat();
-    resized.convertTo(float_img, CV_32F, 1.0/255.0);
-    
-    // 4. Transpose to NCHW
-    auto chw = std::vector<cv::Mat>(3);
-    cv::split(float_img, chw);
-    auto input_tensor = std::vector<float>(input_width * input_height * 3);
-    auto channel_size = input_width * input_height;
-    
-    for (int c = 0; c < 3; ++c) {
-        memcpy(input_tensor.data() + c * channel_size, chw[c].data, channel_size * sizeof(float));
-    }
-    
+        invalidate_tables();
+        return false;
+    }
+    // BGR and BGRA are both packed by the gather: channel selection is done through the tap offsets
+    if (image.type() != CV_8UC3 && image.type() != CV_8UC4) {
+        logger.error("[YOLOv8Preprocessor][ERROR] Unsupported image type, expected 8-bit BGR or BGRA");
+        invalidate_tables();
+        return false;
+    }
+
+    // (Re)build remap tables only when the source geometry changes
+    auto channels = image.channels();
+    if (image.size() != tables.source_size || channels != tables.source_channels) {
+        build_remap_tables(image.size(), channels);
+    }
+    return true;
+}
+
+const std::vector<float>& YOLOv8Preprocessor::prepare_input(const cv::Mat& image) {
+    // 1. Remap tables for this source geometry
+    if (!update_remap_tables(image)) {
+        input_tensor.clear();
+        input_tensor_generation = -1;
+        return input_tensor;
+    }
+
+    // Pad regions never change for a set of tables, fill them once
+    if (input_tensor_generation != tables.generation) {
+        input_tensor.assign(static_cast<size_t>(input_width) * input_height * 3, pad_value / 255.0f);
+        input_tensor_generation = tables.generation;
+    }
+
+    // 2. Bilinear gather straight into the NCHW tensor: BGR(A)->RGB and [0,1] normalization folded in
+    const auto& t = tables;
+    const auto& kernels = CpuDispatch::kernels();
+    auto channel_size = static_cast<size_t>(input_width) * input_height;
+    auto r_plane = input_tensor.data();
+    auto g_plane = r_plane + channel_size;
+    auto b_plane = g_plane + channel_size;
+
+    for (int dy = 0; dy < t.content.height; ++dy) {
+        auto row0 = image.ptr<uchar>(t.y0_rows[dy]);
+        auto row1 = image.ptr<uchar>(t.y1_rows[dy]);
+        auto wy1 = t.y_weights[dy] * (1.0f / 255.0f);
+        auto wy0 = (1.0f / 255.0f) - wy1;
+        auto out_offset = static_cast<size_t>(t.content.y + dy) * input_width + t.content.x;
+        kernels.bilinear_row_planar(row0, row1, t.x0_offsets.data(), t.x1_offsets.data(), t.x_weights.data(), wy0, wy1,
+                                    t.content.width, b_plane + out_offset, g_plane + out_offset, r_plane + out_offset);
+    }
+
     return input_tensor;
-} 
\ No newline at end of file
+}
+
+const cv::Mat& YOLOv8Preprocessor::prepare_input_u8(const cv::Mat& image) {
+    if (!update_remap_tables(image)) {
+        input_image.release();
+        input_image_generation = -1;
+        return input_image;
+    }
+
+    // 1. Frame already matches the model input: hand the captured pixels over untouched
+    const auto& t = tables;
+    if (t.content == cv::Rect(0, 0, input_width, input_height) && image.size() == t.content.size() &&
+        image.type() == CV_8UC3 && image.isContinuous()) {
+        return image;
+    }
+
+    if (input_image_generation != t.generation) {
+        input_image.create(input_height, input_width, CV_8UC3);
+        input_image.setTo(cv::Scalar::all(pad_value));
+        input_image_generation = t.generation;
+    }
+
+    // 2. Same bilinear gather as prepare_input, but kept in uint8 BGR HWC (alpha dropped)
+    const auto& kernels = CpuDispatch::kernels();
+    for (int dy = 0; dy < t.content.height; ++dy) {
+        auto row0 = image.ptr<uchar>(t.y0_rows[dy]);
+        auto row1 = image.ptr<uchar>(t.y1_rows[dy]);
+        auto wy1 = t.y_weights[dy];
+        auto wy0 = 1.0f - wy1;
+        auto out = input_image.ptr<uchar>(t.content.y + dy) + t.content.x * 3;
+        kernels.bilinear_row_bgr(row0, row1, t.x0_offsets.data(), t.x1_offsets.data(), t.x_weights.data(), wy0, wy1,
+                                 t.content.width, out);
+    }
+
+    return input_image;
+}
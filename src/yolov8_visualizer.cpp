@@ -1,9 +1,16 @@
 #include "yolov8_visualizer.hpp"
+#include <cstdio>
 #include <random>
 
-YOLOv8Visualizer::YOLOv8Visualizer(const std::string& config_file) 
-    : config(config_file) {
+YOLOv8Visualizer::YOLOv8Visualizer(const std::string& config_file) {
+    auto config = ConfigManager(config_file);
     initialize_colors();
+    load_style(config);
+}
+
+YOLOv8Visualizer::YOLOv8Visualizer(ConfigManager& config) {
+    initialize_colors();
+    load_style(config);
 }
 
 void YOLOv8Visualizer::initialize_colors() {
@@ -17,98 +24,112 @@ void YOLOv8Visualizer::initialize_colors() {
     }
 }
 
-cv::Mat YOLOv8Visualizer::draw_detections(const cv::Mat& image, const std::vector<Detection>& detections) {
-    auto result = image.clone();
-    
+void YOLOv8Visualizer::load_style(ConfigManager& config) {
     // Load display configuration
     auto box_color = config.get_int_array("Display", "box_color", {0, 0, 255});
     auto text_color = config.get_int_array("Display", "text_color", {255, 255, 255});
-    auto box_thickness = config.get_int("Display", "box_thickness", 2);
-    auto text_scale = config.get_float("Display", "text_scale", 0.5f);
-    auto show_confidence = config.get_string("Display", "show_confidence", "true") == "true";
-    auto show_class_name = config.get_string("Display", "show_class_name", "true") == "true";
-    
-    for (size_t i = 0; i < detections.size(); ++i) {
-        const auto& det = detections[i];
-        
-        // Use configured color or default color
-        auto color = cv::Scalar();
-        if (box_color.size() >= 3) {
-            color = cv::Scalar(box_color[0], box_color[1], box_color[2]);
+    style.use_box_color = box_color.size() >= 3;
+    if (style.use_box_color) {
+        style.box_color = cv::Scalar(box_color[0], box_color[1], box_color[2]);
+    }
+    if (text_color.size() >= 3) {
+        style.text_color = cv::Scalar(text_color[0], text_color[1], text_color[2]);
+    }
+    style.box_thickness = config.get_int("Display", "box_thickness", 2);
+    style.text_scale = config.get_float("Display", "text_scale", 0.5f);
+    style.show_confidence = config.get_string("Display", "show_confidence", "true") == "true";
+    style.show_class_name = config.get_string("Display", "show_class_name", "true") == "true";
+}
+
+const YOLOv8Visualizer::CachedLabel& YOLOv8Visualizer::get_label(const Detection& det) {
+    auto percent = static_cast<int>(det.score * 100);
+    auto key = static_cast<int64_t>(det.class_id) * 1000 + percent;
+    auto it = label_cache.find(key);
+    if (it != label_cache.end()) {
+        return it->second;
+    }
+
+    // Prepare label
+    auto label = std::string();
+    if (style.show_class_name) {
+        if (det.class_id >= 0 && det.class_id < static_cast<int>(class_names.size())) {
+            label = class_names[det.class_id];
         } else {
-            color = colors[det.class_id % colors.size()];
+            label = "Class " + std::to_string(det.class_id);
         }
+    }
+    if (style.show_confidence) {
+        if (!label.empty()) label += " ";
+        label += std::to_string(percent) + "%";
+    }
+    auto baseline = 0;
+    auto size = label.empty() ? cv::Size() : cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, style.text_scale, 1, &baseline);
+    return label_cache.emplace(key, CachedLabel{label, size}).first->second;
+}
+
+cv::Mat YOLOv8Visualizer::draw_detections(const cv::Mat& image, Span<const Detection> detections) {
+    auto result = image.clone();
+    draw_detections_in_place(result, detections);
+    return result;
+}
+
+void YOLOv8Visualizer::draw_detections_in_place(cv::Mat& image, Span<const Detection> detections) {
+    for (const auto& det : detections) {
+        const auto& color = style.use_box_color ? style.box_color : colors[det.class_id % colors.size()];
         
         // Draw bounding box
-        cv::rectangle(result, det.box, color, box_thickness);
-        
-        // Prepare label
-        auto label = std::string();
-        if (show_class_name) {
-            if (det.class_id < class_names.size()) {
-                label = class_names[det.class_id];
-            } else {
-                label = "Class " + std::to_string(det.class_id);
-            }
-        }
-        if (show_confidence) {
-            if (!label.empty()) label += " ";
-            label += std::to_string(static_cast<int>(det.score * 100)) + "%";
-        }
+        auto box = det.rect();
+        cv::rectangle(image, box, color, style.box_thickness);
         
-        if (!label.empty()) {
-            auto baseline = 0;
-            auto text_size = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, text_scale, 1, &baseline);
-            
+        const auto& label = get_label(det);
+        if (!label.text.empty()) {
             // Background of text
-            cv::rectangle(result, 
-                         cv::Point(det.box.x, det.box.y - text_size.height - 10),
-                         cv::Point(det.box.x + text_size.width, det.box.y),
+            cv::rectangle(image, 
+                         cv::Point(box.x, box.y - label.size.height - 10),
+                         cv::Point(box.x + label.size.width, box.y),
                          color, -1);
             
             // Texto
-            auto text_color_scalar = cv::Scalar();
-            if (text_color.size() >= 3) {
-                text_color_scalar = cv::Scalar(text_color[0], text_color[1], text_color[2]);
-            } else {
-                text_color_scalar = cv::Scalar(255, 255, 255);
-            }
-            
-            cv::putText(result, label, 
-                       cv::Point(det.box.x, det.box.y - 5),
-                       cv::FONT_HERSHEY_SIMPLEX, text_scale, text_color_scalar, 1);
+            cv::putText(image, label.text, 
+                       cv::Point(box.x, box.y - 5),
+                       cv::FONT_HERSHEY_SIMPLEX, style.text_scale, style.text_color, 1);
         }
     }
-    
-    return result;
 }
 
-cv::Mat YOLOv8Visualizer::draw_fov_detections(const cv::Mat& fov_image, const std::vector<Detection>& detections, int fov_width, int fov_height) {
+cv::Mat YOLOv8Visualizer::draw_fov_detections(const cv::Mat& fov_image, const FrameDetections& detections, int fov_width, int fov_height) {
     auto result = fov_image.clone();
-    
+    draw_fov_detections_in_place(result, detections, fov_width, fov_height);
+    return result;
+}
+
+void YOLOv8Visualizer::draw_fov_detections_in_place(cv::Mat& image, const FrameDetections& detections, int fov_width, int fov_height) {
     // Draw FOV center crosshair
     auto fov_center = cv::Point(fov_width / 2, fov_height / 2);
-    cv::line(result, cv::Point(fov_center.x - 10, fov_center.y), cv::Point(fov_center.x + 10, fov_center.y), cv::Scalar(0, 255, 0), 2);
-    cv::line(result, cv::Point(fov_center.x, fov_center.y - 10), cv::Point(fov_center.x, fov_center.y + 10), cv::Scalar(0, 255, 0), 2);
+    cv::line(image, cv::Point(fov_center.x - 10, fov_center.y), cv::Point(fov_center.x + 10, fov_center.y), cv::Scalar(0, 255, 0), 2);
+    cv::line(image, cv::Point(fov_center.x, fov_center.y - 10), cv::Point(fov_center.x, fov_center.y + 10), cv::Scalar(0, 255, 0), 2);
     
     // Draw FOV border
-    cv::rectangle(result, cv::Rect(0, 0, fov_width, fov_height), cv::Scalar(0, 255, 0), 2);
+    cv::rectangle(image, cv::Rect(0, 0, fov_width, fov_height), cv::Scalar(0, 255, 0), 2);
     
     // Draw detections with FOV information
-    for (const auto& det : detections) {
+    char info[32];
+    auto has_metrics = detections.fov.size() == detections.size();
+    for (size_t i = 0; i < detections.size(); ++i) {
         // Draw bounding box
-        cv::rectangle(result, det.box, cv::Scalar(0, 0, 255), 2);
+        auto box = detections.detections[i].rect();
+        cv::rectangle(image, box, cv::Scalar(0, 0, 255), 2);
         
         // Draw line from FOV center to detection center
-        auto det_center = cv::Point(det.box.x + det.box.width / 2, det.box.y + det.box.height / 2);
-        cv::line(result, fov_center, det_center, cv::Scalar(255, 0, 0), 1);
+        auto det_center = cv::Point(box.x + box.width / 2, box.y + box.height / 2);
+        cv::line(image, fov_center, det_center, cv::Scalar(255, 0, 0), 1);
         
-        // Draw FOV metrics
-        auto info = "D:" + std::to_string(static_cast<int>(det.fov_distance * 100)) + 
-                          " A:" + std::to_string(static_cast<int>(det.fov_angle * 180 / 3.14159f));
-        cv::putText(result, info, cv::Point(det.box.x, det.box.y - 5), 
+        // Draw FOV metrics (short enough to stay in the small-string buffer)
+        if (!has_metrics) continue;
+        const auto& metrics = detections.fov[i];
+        std::snprintf(info, sizeof(info), "D:%d A:%d", static_cast<int>(metrics.distance * 100),
+                      static_cast<int>(metrics.angle * 180 / 3.14159f));
+        cv::putText(image, info, cv::Point(box.x, box.y - 5), 
                    cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(255, 255, 255), 1);
     }
-    
-    return result;
-} 
\ No newline at end of file
+}
@@ -0,0 +1,141 @@
+"""Append box decoding, TopK and NonMaxSuppression to a YOLOv8 ONNX model.
+
+The exported model emits raw anchors as [1, 4 + num_classes, N] (N = 8400 for
+640x640). This tool appends decode (cxcywh -> xyxy), a best-class reduction,
+a pre-NMS TopK and NonMaxSuppression, so the model emits a small
+[num_dets, 6] tensor of [x1, y1, x2, y2, score, class_id] in model input
+pixels. YOLOv8Postprocessor recognizes that shape and only maps the boxes
+back through the letterbox, skipping host-side decoding and NMS.
+
+Suppression is class-agnostic, matching YOLOv8Postprocessor::non_max_suppression.
+Thresholds are baked into the graph; the host conf_threshold still applies on top.
+
+Usage:
+    python tools/append_nms.py models/blood.onnx models/blood_nms.onnx --conf 0.25 --iou 0.45
+"""
+
+import argparse
+import sys
+
+import numpy as np
+import onnx
+from onnx import TensorProto, helper, numpy_helper
+
+
+def default_opset(model):
+    for opset in model.opset_import:
+        if opset.domain in ("", "ai.onnx"):
+            return opset.version
+    return 0
+
+
+def append_nms(model, conf_threshold, iou_threshold, pre_nms_top_k, max_detections):
+    graph = model.graph
+    opset = default_opset(model)
+    if opset < 13:
+        raise ValueError("opset %d not supported, need >= 13" % opset)
+    if len(graph.output) != 1:
+        raise ValueError("expected exactly one model output, found %d" % len(graph.output))
+
+    raw_output = graph.output[0]
+    dims = [d.dim_value if d.HasField("dim_value") else 0 for d in raw_output.type.tensor_type.shape.dim]
+    if len(dims) != 3 or dims[1] < 5:
+        raise ValueError("expected output [1, 4 + num_classes, N], got %s" % dims)
+    num_anchors = dims[2]
+    top_k = min(pre_nms_top_k, num_anchors) if num_anchors > 0 else pre_nms_top_k
+
+    nodes = []
+    constants = {}
+
+    def const(name, array):
+        constants[name] = numpy_helper.from_array(np.asarray(array), name)
+        return name
+
+    def node(op, inputs, output, **attrs):
+        nodes.append(helper.make_node(op, inputs, [output], name="nms_" + output, **attrs))
+        return output
+
+    # 1. [1, 4 + C, N] -> boxes [1, N, 4] and class scores [1, N, C]
+    preds = node("Transpose", [raw_output.name], "preds", perm=[0, 2, 1])
+    boxes = node("Slice", [preds, const("box_start", np.array([0], np.int64)),
+                           const("box_end", np.array([4], np.int64)),
+                           const("last_axis", np.array([2], np.int64))], "boxes_cxcywh")
+    scores = node("Slice", [preds, const("score_start", np.array([4], np.int64)),
+                            const("score_end", np.array([np.iinfo(np.int64).max], np.int64)),
+                            "last_axis"], "class_scores")
+
+    # 2. Decode cxcywh -> xyxy with one MatMul
+    decode = np.array([[1.0, 0.0, 1.0, 0.0],
+                       [0.0, 1.0, 0.0, 1.0],
+                       [-0.5, 0.0, 0.5, 0.0],
+                       [0.0, -0.5, 0.0, 0.5]], dtype=np.float32)
+    boxes_xyxy = node("MatMul", [boxes, const("decode_matrix", decode)], "boxes_xyxy")
+    axis0 = const("axis0", np.array([0], np.int64))
+    boxes_2d = node("Squeeze", [boxes_xyxy, axis0], "boxes_2d")
+
+    # 3. Best class per anchor
+    if opset >= 18:
+        best_scores = node("ReduceMax", [scores, "last_axis"], "best_scores", keepdims=0)
+    else:
+        best_scores = node("ReduceMax", [scores], "best_scores", axes=[2], keepdims=0)
+    best_classes = node("ArgMax", [scores], "best_classes", axis=2, keepdims=0)
+    scores_1d = node("Squeeze", [best_scores, axis0], "scores_1d")
+    classes_1d = node("Squeeze", [best_classes, axis0], "classes_1d")
+
+    # 4. Pre-NMS TopK keeps the NMS input small. k is clamped to the anchor count in the
+    #    graph: with dynamic shapes, small inputs have fewer anchors than --pre-nms-top-k
+    num_anchors_1d = node("Shape", [scores_1d], "num_anchors")
+    k = node("Min", [const("top_k", np.array([top_k], np.int64)), num_anchors_1d], "top_k_clamped")
+    nodes.append(helper.make_node("TopK", [scores_1d, k], ["top_scores", "top_indices"], name="nms_topk", axis=0))
+    top_boxes = node("Gather", [boxes_2d, "top_indices"], "top_boxes", axis=0)
+    top_classes = node("Gather", [classes_1d, "top_indices"], "top_classes", axis=0)
+
+    # 5. NonMaxSuppression over [1, K, 4] boxes and [1, 1, K] scores
+    nms_boxes = node("Unsqueeze", [top_boxes, axis0], "nms_boxes")
+    nms_scores = node("Unsqueeze", ["top_scores", const("axes01", np.array([0, 1], np.int64))], "nms_scores")
+    selected = node("NonMaxSuppression", [nms_boxes, nms_scores,
+                                          const("max_detections", np.array([max_detections], np.int64)),
+                                          const("iou_threshold", np.array([iou_threshold], np.float32)),
+                                          const("score_threshold", np.array([conf_threshold], np.float32))],
+                    "selected", center_point_box=0)
+    box_column = node("Gather", [selected, const("box_column", np.array([2], np.int64))], "selected_column", axis=1)
+    keep = node("Squeeze", [box_column, const("axis1", np.array([1], np.int64))], "keep")
+
+    # 6. [num_dets, 6] = [x1, y1, x2, y2, score, class_id]
+    det_boxes = node("Gather", [top_boxes, keep], "det_boxes", axis=0)
+    det_scores = node("Unsqueeze", [node("Gather", ["top_scores", keep], "kept_scores", axis=0), "axis1"], "det_scores")
+    det_classes = node("Unsqueeze", [node("Cast", [node("Gather", [top_classes, keep], "kept_classes", axis=0)],
+                                          "kept_classes_f32", to=TensorProto.FLOAT), "axis1"], "det_classes")
+    node("Concat", [det_boxes, det_scores, det_classes], "detections", axis=1)
+
+    graph.initializer.extend(constants.values())
+    graph.node.extend(nodes)
+    graph.output.remove(raw_output)
+    graph.output.append(helper.make_tensor_value_info("detections", TensorProto.FLOAT, ["num_dets", 6]))
+    return model
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="exported YOLOv8 ONNX model")
+    parser.add_argument("output", help="path of the model with embedded NMS")
+    parser.add_argument("--conf", type=float, default=0.25, help="score threshold applied before NMS")
+    parser.add_argument("--iou", type=float, default=0.45, help="NMS IoU threshold")
+    parser.add_argument("--pre-nms-top-k", type=int, default=1000, help="anchors kept before NMS")
+    parser.add_argument("--max-detections", type=int, default=100, help="maximum detections per frame")
+    args = parser.parse_args()
+
+    model = onnx.load(args.input)
+    try:
+        model = append_nms(model, args.conf, args.iou, args.pre_nms_top_k, args.max_detections)
+    except ValueError as e:
+        print("[append_nms][ERROR] %s" % e, file=sys.stderr)
+        return 1
+    onnx.checker.check_model(model)
+    onnx.save(model, args.output)
+    print("[append_nms][INFO] Wrote %s" % args.output)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,90 @@
+"""Prepend uint8 HWC input handling to a YOLOv8 ONNX model.
+
+The exported model takes a float32 NCHW RGB tensor in [0, 1]. This tool adds
+Cast -> Div(255) -> Transpose (and a BGR->RGB channel swap) in front of the
+graph so the model accepts raw uint8 BGR pixels as [1, H, W, 3]. The host then
+feeds captured frames directly and ORT can fold the normalization into the
+first convolution.
+
+Usage:
+    python tools/prepare_uint8_input.py models/blood.onnx models/blood_u8.onnx
+"""
+
+import argparse
+import sys
+
+import numpy as np
+import onnx
+from onnx import TensorProto, helper, numpy_helper
+
+
+def prepare_uint8_input(model, rgb_input=False):
+    graph = model.graph
+    initializer_names = {init.name for init in graph.initializer}
+    inputs = [inp for inp in graph.input if inp.name not in initializer_names]
+    if len(inputs) != 1:
+        raise ValueError("expected exactly one model input, found %d" % len(inputs))
+
+    float_input = inputs[0]
+    tensor_type = float_input.type.tensor_type
+    if tensor_type.elem_type != TensorProto.FLOAT:
+        raise ValueError("model input %s is not float32" % float_input.name)
+
+    dims = [d.dim_value if d.HasField("dim_value") else d.dim_param for d in tensor_type.shape.dim]
+    if len(dims) != 4 or dims[1] != 3:
+        raise ValueError("expected NCHW input with 3 channels, got %s" % dims)
+    batch, _, height, width = dims
+
+    # The original input name becomes an internal value produced by the new nodes
+    original_name = float_input.name
+    u8_name = original_name + "_u8"
+    u8_input = helper.make_tensor_value_info(u8_name, TensorProto.UINT8, [batch, height, width, 3])
+
+    scale_name = original_name + "_scale"
+    graph.initializer.append(numpy_helper.from_array(np.array(255.0, dtype=np.float32), scale_name))
+
+    nodes = [
+        helper.make_node("Cast", [u8_name], [original_name + "_f32"], to=TensorProto.FLOAT,
+                         name="input_u8_cast"),
+        helper.make_node("Div", [original_name + "_f32", scale_name], [original_name + "_norm"],
+                         name="input_u8_normalize"),
+    ]
+    hwc_name = original_name + "_norm"
+    if not rgb_input:
+        # Our frames are BGR; the exported network expects RGB
+        order_name = original_name + "_channel_order"
+        graph.initializer.append(numpy_helper.from_array(np.array([2, 1, 0], dtype=np.int64), order_name))
+        nodes.append(helper.make_node("Gather", [hwc_name, order_name], [original_name + "_rgb"], axis=3,
+                                      name="input_u8_bgr_to_rgb"))
+        hwc_name = original_name + "_rgb"
+    nodes.append(helper.make_node("Transpose", [hwc_name], [original_name], perm=[0, 3, 1, 2],
+                                  name="input_u8_to_nchw"))
+
+    graph.input.remove(float_input)
+    graph.input.insert(0, u8_input)
+    for node in reversed(nodes):
+        graph.node.insert(0, node)
+    return model
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="exported float32 YOLOv8 ONNX model")
+    parser.add_argument("output", help="path of the uint8 model to write")
+    parser.add_argument("--rgb", action="store_true", help="input pixels are already RGB (skip channel swap)")
+    args = parser.parse_args()
+
+    model = onnx.load(args.input)
+    try:
+        model = prepare_uint8_input(model, rgb_input=args.rgb)
+    except ValueError as e:
+        print("[prepare_uint8_input][ERROR] %s" % e, file=sys.stderr)
+        return 1
+    onnx.checker.check_model(model)
+    onnx.save(model, args.output)
+    print("[prepare_uint8_input][INFO] Wrote %s" % args.output)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())